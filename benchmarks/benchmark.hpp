@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "barriers.hpp"
+#include "spin_wait.hpp"
+
+namespace lockfreekit::bench {
+
+// Runs body(thread_index) on `threads` threads, released together once all of them are up, and returns the
+// wall-clock seconds from the release until the last one finished.
+template <typename Body>
+double run_timed(size_t threads, Body&& body) {
+    Latch ready(static_cast<uint32_t>(threads));
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            ready.count_down();
+            while (!go.load(std::memory_order_acquire)) {
+                cpu_relax();
+            }
+            body(t);
+        });
+    }
+    ready.wait();
+    const auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Positional command-line argument `index`, or `fallback` when absent.
+inline size_t arg_or(int argc, char** argv, int index, size_t fallback) {
+    return argc > index ? static_cast<size_t>(std::strtoull(argv[index], nullptr, 10)) : fallback;
+}
+
+}  // namespace lockfreekit::bench
@@ -0,0 +1,82 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+#include "benchmark.hpp"
+#include "queue_locks.hpp"
+#include "spin_wait.hpp"
+
+// Lock handoff throughput under contention over a range of thread counts. Every thread loops: take the lock,
+// update a few shared cache lines (a queue resize or a combiner's pass in miniature), release, do a little
+// private work. Usage: lock_benchmark [acquisitions_per_thread] [max_threads]
+//
+// The test-and-test-and-set spin lock is the baseline the queue locks exist to beat: every release sends all
+// its waiters for the same line. With more threads than cores the pure spin locks collapse (a preempted holder
+// or queued waiter stalls everyone behind it) and HybridMutex, which parks, should hold up best.
+
+namespace {
+
+using namespace lockfreekit;
+
+class TtasLock {
+   public:
+    void lock() noexcept {
+        for (SpinWait spin;; spin.wait()) {
+            if (!locked_.load(std::memory_order_relaxed) && !locked_.exchange(true, std::memory_order_acquire)) {
+                return;
+            }
+        }
+    }
+    void unlock() noexcept { locked_.store(false, std::memory_order_release); }
+
+   private:
+    std::atomic<bool> locked_{false};
+};
+
+// Shared state the critical section writes, a few lines apart
+struct alignas(64) Line {
+    uint64_t value = 0;
+};
+
+template <typename Lock>
+double throughput(size_t threads, size_t per_thread) {
+    Lock lock;
+    Line shared[4];
+    std::atomic<uint64_t> sink{0};
+    const double seconds = bench::run_timed(threads, [&](size_t t) {
+        uint64_t local = t;
+        for (size_t i = 0; i < per_thread; ++i) {
+            {
+                std::lock_guard guard(lock);
+                for (Line& line : shared) {
+                    line.value += local;
+                }
+            }
+            for (int work = 0; work < 32; ++work) {
+                local = local * 6364136223846793005ull + 1442695040888963407ull;
+            }
+        }
+        sink.fetch_add(local, std::memory_order_relaxed);  // Keeps the private work alive
+    });
+    return static_cast<double>(threads * per_thread) / seconds / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t per_thread = bench::arg_or(argc, argv, 1, 200000);
+    const size_t max_threads = bench::arg_or(argc, argv, 2, 64);
+
+    std::printf("%8s %12s %12s %12s %12s %12s   (Macquisitions/s, %zu per thread)\n", "threads", "std::mutex",
+                "TTAS", "McsLock", "ClhLock", "HybridMutex", per_thread);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        const double standard = throughput<std::mutex>(threads, per_thread);
+        const double ttas = throughput<TtasLock>(threads, per_thread);
+        const double mcs = throughput<McsLock>(threads, per_thread);
+        const double clh = throughput<ClhLock>(threads, per_thread);
+        const double hybrid = throughput<HybridMutex>(threads, per_thread);
+        std::printf("%8zu %12.2f %12.2f %12.2f %12.2f %12.2f\n", threads, standard, ttas, mcs, clh, hybrid);
+    }
+    return 0;
+}
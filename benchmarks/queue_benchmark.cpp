@@ -0,0 +1,109 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "flat_combining_queue.hpp"
+#include "mpmc_queue.hpp"
+#include "wait_free_queue.hpp"
+
+// Producer/consumer throughput of the queue variants over a range of thread counts. Half the threads produce,
+// half consume. Usage: queue_benchmark [items_per_producer] [max_threads]
+//
+// The CAS-based MPMCQueue wins at low thread counts; the thread count where FlatCombiningQueue overtakes it
+// (typically a few dozen threads on multi-socket machines) is the crossover the table is meant to show.
+
+namespace {
+
+using namespace lockfreekit;
+
+constexpr size_t CAPACITY = 1024;
+
+struct MPMCAdapter {
+    struct Handle {};
+    explicit MPMCAdapter(size_t) : queue(CAPACITY) {}
+    Handle handle() { return {}; }
+    bool push(Handle&, uint64_t v) { return queue.enqueue(v); }
+    std::optional<uint64_t> pop(Handle&) { return queue.dequeue(); }
+    MPMCQueue<uint64_t> queue;
+};
+
+struct FlatCombiningAdapter {
+    using Handle = FlatCombiningQueue<uint64_t>::Handle*;
+    explicit FlatCombiningAdapter(size_t threads) : queue(CAPACITY, threads) {}
+    Handle handle() { return &queue.register_thread(); }
+    bool push(Handle& h, uint64_t v) { return queue.enqueue(*h, v); }
+    std::optional<uint64_t> pop(Handle& h) { return queue.dequeue(*h); }
+    FlatCombiningQueue<uint64_t> queue;
+};
+
+// The wait-free queue carries pointers; every producer owns a block of payloads to point into
+struct WaitFreeAdapter {
+    using Handle = WaitFreeQueue<uint64_t>::Handle*;
+    explicit WaitFreeAdapter(size_t threads) : queue(threads) {}
+    Handle handle() { return &queue.register_thread(); }
+    bool push(Handle& h, uint64_t& v) {
+        queue.enqueue(*h, &v);
+        return true;
+    }
+    std::optional<uint64_t> pop(Handle& h) {
+        uint64_t* v = queue.dequeue(*h);
+        return v ? std::optional<uint64_t>(*v) : std::nullopt;
+    }
+    WaitFreeQueue<uint64_t> queue;
+};
+
+template <typename Adapter>
+double throughput(size_t threads, size_t per_producer) {
+    const size_t producers = threads / 2;
+    const size_t total = producers * per_producer;
+    Adapter adapter(threads);
+    std::vector<std::unique_ptr<uint64_t[]>> payloads;
+    for (size_t p = 0; p < producers; ++p) {
+        payloads.push_back(std::make_unique<uint64_t[]>(per_producer));
+    }
+    std::atomic<size_t> consumed{0};
+
+    const double seconds = bench::run_timed(threads, [&](size_t t) {
+        auto handle = adapter.handle();
+        if (t < producers) {
+            uint64_t* payload = payloads[t].get();
+            for (size_t i = 0; i < per_producer; ++i) {
+                payload[i] = i;
+                while (!adapter.push(handle, payload[i])) {
+                    std::this_thread::yield();
+                }
+            }
+        } else {
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (adapter.pop(handle)) {
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    });
+    return static_cast<double>(total) / seconds / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t per_producer = bench::arg_or(argc, argv, 1, 200000);
+    const size_t max_threads = bench::arg_or(argc, argv, 2, 64);
+
+    std::printf("%8s %14s %14s %14s   (Mops/s, %zu items per producer)\n", "threads", "MPMCQueue", "FlatCombining",
+                "WaitFree", per_producer);
+    for (size_t threads = 2; threads <= max_threads; threads *= 2) {
+        const double cas = throughput<MPMCAdapter>(threads, per_producer);
+        const double fc = throughput<FlatCombiningAdapter>(threads, per_producer);
+        const double wf = throughput<WaitFreeAdapter>(threads, per_producer);
+        std::printf("%8zu %14.2f %14.2f %14.2f%s\n", threads, cas, fc, wf, fc > cas ? "   <- combining ahead" : "");
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "benchmark.hpp"
+#include "slab_allocator.hpp"
+#include "spsc_queue.hpp"
+
+// Producer->consumer ping-pong: one thread allocates messages and passes them through an SPSC ring, the other
+// frees them, so every free is a cross-thread free. Compares the system allocator with SlabAllocator over a
+// few message sizes. Usage: slab_benchmark [messages]
+
+namespace {
+
+using namespace lockfreekit;
+
+struct SystemAdapter {
+    void* allocate(size_t bytes) { return ::operator new(bytes); }
+    void deallocate(void* pointer) { ::operator delete(pointer); }
+};
+
+struct SlabAdapter {
+    void* allocate(size_t bytes) { return slab.allocate(bytes); }
+    void deallocate(void* pointer) { slab.deallocate(pointer); }
+    SlabAllocator slab;
+};
+
+template <typename Adapter>
+double throughput(size_t messages, size_t bytes) {
+    Adapter adapter;
+    SPSCQueue<void*> ring(1024);
+    const double seconds = bench::run_timed(2, [&](size_t t) {
+        if (t == 0) {
+            for (size_t i = 0; i < messages; ++i) {
+                auto* message = static_cast<uint64_t*>(adapter.allocate(bytes));
+                message[0] = i;  // Touch it, as a real producer would
+                while (!ring.enqueue(message)) {
+                    std::this_thread::yield();
+                }
+            }
+        } else {
+            for (size_t received = 0; received < messages;) {
+                if (const auto message = ring.dequeue()) {
+                    adapter.deallocate(*message);
+                    ++received;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    });
+    return static_cast<double>(messages) / seconds / 1e6;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t messages = bench::arg_or(argc, argv, 1, 2000000);
+
+    std::printf("%8s %14s %14s   (Mmsgs/s, %zu messages)\n", "bytes", "system", "SlabAllocator", messages);
+    for (const size_t bytes : {16, 64, 256, 1024, 4096}) {
+        const double system = throughput<SystemAdapter>(messages, bytes);
+        const double slab = throughput<SlabAdapter>(messages, bytes);
+        std::printf("%8zu %14.2f %14.2f\n", bytes, system, slab);
+    }
+    return 0;
+}
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "intrusive_mpsc_queue.hpp"
+#include "mpmc_queue.hpp"
+#include "spin_wait.hpp"
+#include "work_stealing_deque.hpp"
+
+namespace lockfreekit {
+
+class ActorRuntime;
+
+// Scheduling state of an actor, independent of its message type. See Actor<Message>.
+class ActorBase {
+   public:
+    virtual ~ActorBase() = default;
+
+    // Delete copy/move constructors and assignment operators
+    ActorBase(const ActorBase&) = delete;
+    ActorBase& operator=(const ActorBase&) = delete;
+    ActorBase(ActorBase&&) = delete;
+    ActorBase& operator=(ActorBase&&) = delete;
+
+   protected:
+    // `quota` is the number of messages handled per activation; 0 takes the runtime's default.
+    explicit ActorBase(ActorRuntime& runtime, size_t quota = 0) noexcept : runtime_(runtime), quota_(quota) {}
+
+    // Makes sure the actor is scheduled after a message was pushed into its mailbox.
+    void notify();
+
+   private:
+    friend class ActorRuntime;
+
+    // Handles up to `max_messages` messages and returns how many there were.
+    virtual size_t drain(size_t max_messages) = 0;
+    [[nodiscard]] virtual bool mailbox_empty() const noexcept = 0;
+
+    ActorRuntime& runtime_;
+    const size_t quota_;
+    // True from the moment the actor is queued for a worker until its activation ends with an empty mailbox
+    std::atomic<bool> scheduled_{false};
+};
+
+// Runs actors on a fixed pool of worker threads.
+//
+// An actor is queued when its mailbox goes from empty to non-empty and at most one worker activates it at a
+// time. Each worker keeps ready actors in a Chase-Lev deque, so an actor woken by a message sent from a worker
+// runs next on that (cache-warm) worker unless an idle worker steals it. Actors woken from outside the pool, and
+// actors that used up their quota and still have mail, go to a shared MPMCQueue so that a busy mailbox cannot
+// starve the others. Idle workers spin briefly, then park until new work is scheduled.
+class ActorRuntime {
+   public:
+    static constexpr size_t DEFAULT_QUOTA = 64;
+
+    explicit ActorRuntime(size_t workers, size_t quota = DEFAULT_QUOTA, size_t deque_capacity = 1024,
+                          size_t injection_capacity = 1 << 16)
+        : injection_(injection_capacity), quota_(quota) {
+        if (workers < 1) {
+            throw std::invalid_argument("ActorRuntime needs at least one worker");
+        }
+        if (quota_ < 1) {
+            throw std::invalid_argument("ActorRuntime quota must be > 0");
+        }
+        for (size_t i = 0; i < workers; ++i) {
+            workers_.push_back(std::make_unique<Worker>(deque_capacity, i));
+        }
+        for (size_t i = 0; i < workers; ++i) {
+            workers_[i]->thread = std::thread([this, i] { run_worker(*workers_[i]); });
+        }
+    }
+
+    // Stops the workers after their current activation. Messages still in mailboxes are not processed; actors
+    // must outlive the runtime or be quiescent when destroyed.
+    ~ActorRuntime() {
+        stopping_.store(true, std::memory_order_release);
+        wake_epoch_.fetch_add(1, std::memory_order_release);
+        wake_epoch_.notify_all();
+        for (auto& worker : workers_) {
+            worker->thread.join();
+        }
+    }
+
+    [[nodiscard]] size_t worker_count() const noexcept { return workers_.size(); }
+
+    [[nodiscard]] size_t default_quota() const noexcept { return quota_; }
+
+    // Delete copy/move constructors and assignment operators
+    ActorRuntime(const ActorRuntime&) = delete;
+    ActorRuntime& operator=(const ActorRuntime&) = delete;
+    ActorRuntime(ActorRuntime&&) = delete;
+    ActorRuntime& operator=(ActorRuntime&&) = delete;
+
+   private:
+    friend class ActorBase;
+
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    // Empty find_work() rounds before a worker parks
+    static constexpr uint32_t IDLE_ROUNDS_ = 128;
+    // A worker checks the shared queue before its own deque every this many activations
+    static constexpr uint32_t INJECTION_POLL_INTERVAL_ = 61;
+
+    struct alignas(CACHE_LINE_SIZE_) Worker {
+        Worker(size_t deque_capacity, size_t index) : deque(deque_capacity), rng(index * 0x9e3779b97f4a7c15ULL + 1) {}
+
+        WorkStealingDeque<ActorBase*> deque;
+        std::thread thread;
+        uint64_t rng;
+        uint32_t ticks = 0;
+    };
+
+    inline static thread_local ActorRuntime* current_runtime_ = nullptr;
+    inline static thread_local Worker* current_worker_ = nullptr;
+
+    void schedule(ActorBase* actor) {
+        Worker* worker = current_runtime_ == this ? current_worker_ : nullptr;
+        if (worker == nullptr || !worker->deque.push(actor)) {
+            inject(actor);
+        }
+        wake_one();
+    }
+
+    void inject(ActorBase* actor) {
+        for (SpinWait spin; !injection_.enqueue(actor);) {
+            spin.wait();
+        }
+    }
+
+    void wake_one() {
+        // Pairs with the fence in run_worker(): either we see the sleeper, or it sees the work we just queued
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) > 0) {
+            wake_epoch_.fetch_add(1, std::memory_order_release);
+            wake_epoch_.notify_one();
+        }
+    }
+
+    void run_worker(Worker& worker) {
+        current_runtime_ = this;
+        current_worker_ = &worker;
+        uint32_t idle_rounds = 0;
+        while (!stopping_.load(std::memory_order_acquire)) {
+            if (ActorBase* actor = find_work(worker)) {
+                activate(actor);
+                idle_rounds = 0;
+                continue;
+            }
+            if (++idle_rounds < IDLE_ROUNDS_) {
+                std::this_thread::yield();
+                continue;
+            }
+            idle_rounds = 0;
+            const uint32_t epoch = wake_epoch_.load(std::memory_order_acquire);
+            sleepers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!has_work() && !stopping_.load(std::memory_order_acquire)) {
+                wake_epoch_.wait(epoch, std::memory_order_acquire);
+            }
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        current_worker_ = nullptr;
+        current_runtime_ = nullptr;
+    }
+
+    ActorBase* find_work(Worker& worker) {
+        if (++worker.ticks % INJECTION_POLL_INTERVAL_ == 0) {
+            if (auto actor = injection_.dequeue()) {
+                return *actor;
+            }
+        }
+        if (auto actor = worker.deque.pop()) {
+            return *actor;
+        }
+        if (auto actor = injection_.dequeue()) {
+            return *actor;
+        }
+        // Steal, starting from a random victim (xorshift64)
+        worker.rng ^= worker.rng << 13;
+        worker.rng ^= worker.rng >> 7;
+        worker.rng ^= worker.rng << 17;
+        const size_t count = workers_.size();
+        const size_t start = static_cast<size_t>(worker.rng % count);
+        for (size_t i = 0; i < count; ++i) {
+            Worker& victim = *workers_[(start + i) % count];
+            if (&victim == &worker) {
+                continue;
+            }
+            if (auto actor = victim.deque.steal()) {
+                return *actor;
+            }
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] bool has_work() const noexcept {
+        if (!injection_.empty()) {
+            return true;
+        }
+        for (const auto& worker : workers_) {
+            if (worker->deque.approx_size() > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void activate(ActorBase* actor) {
+        const size_t quota = actor->quota_ > 0 ? actor->quota_ : quota_;
+        if (actor->drain(quota) == quota) {
+            // Possibly more mail: stay scheduled, but go to the back of the shared line
+            inject(actor);
+            wake_one();
+            return;
+        }
+        // Dekker-style handshake with ActorBase::notify(): publish "idle", then re-check the mailbox. A sender
+        // either sees scheduled_ == false and schedules us, or its message is visible to the check below.
+        actor->scheduled_.store(false, std::memory_order_seq_cst);
+        if (!actor->mailbox_empty() && !actor->scheduled_.exchange(true, std::memory_order_acq_rel)) {
+            schedule(actor);
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    MPMCQueue<ActorBase*> injection_;
+    const size_t quota_;
+    std::atomic<bool> stopping_{false};
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<uint32_t> sleepers_{0};
+    char pad0[CACHE_LINE_SIZE_ - sizeof(sleepers_)]{};
+    alignas(CACHE_LINE_SIZE_) std::atomic<uint32_t> wake_epoch_{0};
+    char pad1[CACHE_LINE_SIZE_ - sizeof(wake_epoch_)]{};
+};
+
+inline void ActorBase::notify() {
+    // The seq_cst load pairs with the mailbox's seq_cst XCHG in push() and with ActorRuntime::activate()
+    if (!scheduled_.load(std::memory_order_seq_cst) && !scheduled_.exchange(true, std::memory_order_acq_rel)) {
+        runtime_.schedule(this);
+    }
+}
+
+// An actor with a lock-free intrusive mailbox of `Message`s (which derive from IntrusiveMPSCNode, so sending
+// never allocates). receive() runs on a runtime worker, never concurrently with itself for the same actor.
+template <typename Message>
+requires std::derived_from<Message, IntrusiveMPSCNode>
+class Actor : public ActorBase {
+   public:
+    // Any thread. The message is linked into the mailbox, so it must stay alive and must not be sent again
+    // until receive() got it.
+    void send(Message* message) {
+        mailbox_.push(message);
+        notify();
+    }
+
+   protected:
+    using ActorBase::ActorBase;
+
+    virtual void receive(Message* message) = 0;
+
+   private:
+    size_t drain(size_t max_messages) final {
+        size_t handled = 0;
+        while (handled < max_messages) {
+            Message* message = mailbox_.pop();
+            if (message == nullptr) {
+                break;
+            }
+            receive(message);
+            ++handled;
+        }
+        return handled;
+    }
+
+    [[nodiscard]] bool mailbox_empty() const noexcept final { return mailbox_.empty(); }
+
+    IntrusiveMPSCQueue<Message> mailbox_;
+};
+
+}  // namespace lockfreekit
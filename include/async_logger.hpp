@@ -0,0 +1,309 @@
+#pragma once
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "mpmc_queue.hpp"
+#include "spin_wait.hpp"
+
+namespace lockfreekit {
+
+enum class LogLevel : uint8_t { debug, info, warning, error };
+
+// What log() does when the queue is full
+enum class OverflowPolicy {
+    block,           // Wait for the background thread (never loses a message)
+    drop,            // Discard the message
+    drop_and_count,  // Discard it and have the background thread report how many were lost
+};
+
+// Asynchronous printf-style logger. The call site only captures: it copies the format string pointer, a
+// timestamp and the arguments in binary form into a fixed-size record and enqueues that into an MPMCQueue. A
+// background thread formats the records with snprintf and writes them in batches with one writev() per batch.
+//
+// The format string must outlive the logger (use literals). Arguments may be arithmetic types, enums, pointers
+// and strings (const char*, std::string, std::string_view); strings are copied into the record and truncated if
+// the record runs out of room. Needs POSIX (writev).
+class AsyncLogger {
+   public:
+    static constexpr size_t RECORD_ARGS_BYTES = 200;
+
+    explicit AsyncLogger(int fd, size_t capacity = 1 << 14, OverflowPolicy policy = OverflowPolicy::block,
+                         LogLevel min_level = LogLevel::info)
+        : fd_(fd), policy_(policy), min_level_(min_level), queue_(capacity) {
+        writer_ = std::thread([this] { run(); });
+    }
+
+    // Writes everything logged before, then stops the background thread
+    ~AsyncLogger() {
+        stopping_.store(true, std::memory_order_release);
+        writer_.join();
+    }
+
+    [[nodiscard]] bool enabled(LogLevel level) const noexcept { return level >= min_level_; }
+
+    // Returns false if the message was filtered out or dropped
+    template <typename... Args>
+    bool log(LogLevel level, const char* format, const Args&... args) {
+        if (!enabled(level)) {
+            return false;
+        }
+        constexpr size_t fixed = (fixed_size<std::decay_t<const Args&>>() + ... + 0);
+        static_assert(fixed <= RECORD_ARGS_BYTES, "Too many log arguments for one record");
+        Record record;
+        record.format = format;
+        record.formatter = &format_record<std::decay_t<const Args&>...>;
+        record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  std::chrono::system_clock::now().time_since_epoch())
+                                  .count();
+        record.level = level;
+        [[maybe_unused]] size_t used = 0;
+        // Shared by the contents of all string arguments
+        [[maybe_unused]] size_t text_room = RECORD_ARGS_BYTES - fixed;
+        // Every argument is handled as its decayed type, the same in fixed_size(), format_record() and here: an
+        // array is captured as a pointer to its (const) elements
+        (encode<std::decay_t<const Args&>>(record.args, used, text_room, args), ...);
+
+        if (queue_.enqueue(record)) {
+            return true;
+        }
+        switch (policy_) {
+            case OverflowPolicy::block:
+                for (SpinWait spin; !queue_.enqueue(record);) {
+                    spin.wait();
+                }
+                return true;
+            case OverflowPolicy::drop_and_count:
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            case OverflowPolicy::drop:
+                break;
+        }
+        return false;
+    }
+
+    template <typename... Args>
+    bool info(const char* format, const Args&... args) {
+        return log(LogLevel::info, format, args...);
+    }
+
+    template <typename... Args>
+    bool warning(const char* format, const Args&... args) {
+        return log(LogLevel::warning, format, args...);
+    }
+
+    template <typename... Args>
+    bool error(const char* format, const Args&... args) {
+        return log(LogLevel::error, format, args...);
+    }
+
+    // Waits until every message logged before the call has been written
+    void flush() {
+        for (SpinWait spin; !queue_.empty() || busy_.load(std::memory_order_seq_cst);) {
+            spin.wait();
+        }
+    }
+
+    // Delete copy/move constructors and assignment operators
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+    AsyncLogger(AsyncLogger&&) = delete;
+    AsyncLogger& operator=(AsyncLogger&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    // Records per writev(); IOV_MAX is at least 1024 on Linux
+    static constexpr size_t BATCH_ = 64;
+    static constexpr size_t LINE_BYTES_ = 1024;
+    static constexpr auto IDLE_SLEEP_ = std::chrono::milliseconds(1);
+
+    using Formatter = int (*)(char* out, size_t size, const char* format, const unsigned char* args);
+
+    // No member initializers: log() fills in every field, and the queue default-constructs its slots
+    struct Record {
+        const char* format;
+        Formatter formatter;
+        int64_t timestamp_ns;
+        LogLevel level;
+        alignas(8) unsigned char args[RECORD_ARGS_BYTES];
+    };
+
+    template <typename T>
+    static constexpr bool is_string_ =
+        std::is_same_v<T, const char*> || std::is_same_v<T, char*> || std::is_convertible_v<const T&, std::string_view>;
+
+    // Bytes an argument takes in the record, not counting string contents
+    template <typename T>
+    static constexpr size_t fixed_size() {
+        if constexpr (is_string_<T>) {
+            return sizeof(uint16_t) + 1;  // Length and terminator
+        } else if constexpr (std::is_enum_v<T>) {
+            return sizeof(std::underlying_type_t<T>);
+        } else {
+            static_assert(std::is_arithmetic_v<T> || std::is_pointer_v<T>, "Unsupported log argument type");
+            return sizeof(T);
+        }
+    }
+
+    template <typename T>
+    static void encode(unsigned char* args, size_t& used, size_t& text_room, const T& value) noexcept {
+        if constexpr (is_string_<T>) {
+            std::string_view text;
+            if constexpr (std::is_pointer_v<T>) {
+                text = value != nullptr ? std::string_view(value) : std::string_view("(null)");
+            } else {
+                text = value;
+            }
+            const auto length = static_cast<uint16_t>(std::min(text.size(), text_room));
+            text_room -= length;
+            std::memcpy(args + used, &length, sizeof(length));
+            std::memcpy(args + used + sizeof(length), text.data(), length);
+            args[used + sizeof(length) + length] = '\0';
+            used += sizeof(length) + length + 1;
+        } else if constexpr (std::is_enum_v<T>) {
+            encode(args, used, text_room, static_cast<std::underlying_type_t<T>>(value));
+        } else {
+            std::memcpy(args + used, &value, sizeof(T));
+            used += sizeof(T);
+        }
+    }
+
+    // What a captured argument is passed to snprintf as
+    template <typename T>
+    static auto decode(const unsigned char* args, size_t& used) noexcept {
+        if constexpr (is_string_<T>) {
+            uint16_t length = 0;
+            std::memcpy(&length, args + used, sizeof(length));
+            const auto* text = reinterpret_cast<const char*>(args + used + sizeof(length));
+            used += sizeof(length) + length + 1;
+            return text;
+        } else if constexpr (std::is_enum_v<T>) {
+            return decode<std::underlying_type_t<T>>(args, used);
+        } else {
+            T value;
+            std::memcpy(&value, args + used, sizeof(T));
+            used += sizeof(T);
+            return value;
+        }
+    }
+
+    template <typename... Args>
+    static int format_record(char* out, size_t size, const char* format, const unsigned char* args) {
+        size_t used = 0;
+        // Braced initialization evaluates the decodes left to right
+        const std::tuple<decltype(decode<Args>(args, used))...> values{decode<Args>(args, used)...};
+        (void)used;
+        return std::apply(
+            [&](auto... decoded) {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-security"
+                return std::snprintf(out, size, format, decoded...);
+#pragma GCC diagnostic pop
+            },
+            values);
+    }
+
+    // "2026-01-31 12:00:00.123456 INFO  message\n" into `line`; returns the length
+    static size_t format_line(const Record& record, char* line) {
+        static constexpr const char* LEVEL_NAMES[] = {"DEBUG", "INFO ", "WARN ", "ERROR"};
+        const time_t seconds = static_cast<time_t>(record.timestamp_ns / 1000000000);
+        tm utc{};
+        gmtime_r(&seconds, &utc);
+        size_t length = std::strftime(line, LINE_BYTES_, "%Y-%m-%d %H:%M:%S", &utc);
+        length += static_cast<size_t>(std::snprintf(line + length, LINE_BYTES_ - length, ".%06d %s ",
+                                                    static_cast<int>(record.timestamp_ns / 1000 % 1000000),
+                                                    LEVEL_NAMES[static_cast<size_t>(record.level)]));
+        const int written = record.formatter(line + length, LINE_BYTES_ - length - 1, record.format, record.args);
+        if (written > 0) {
+            length += std::min(static_cast<size_t>(written), LINE_BYTES_ - length - 2);  // Truncated if too long
+        }
+        line[length++] = '\n';
+        return length;
+    }
+
+    void run() {
+        std::vector<char> lines(BATCH_ * LINE_BYTES_);
+        iovec iov[BATCH_];
+        for (;;) {
+            // Set before dequeuing so that flush() cannot see an empty queue while a batch is still unwritten
+            busy_.store(true, std::memory_order_seq_cst);
+            size_t count = 0;
+            if (const uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed); dropped > 0) {
+                char* line = &lines[0];
+                const int length = std::snprintf(line, LINE_BYTES_, "[logger] %llu messages dropped\n",
+                                                 static_cast<unsigned long long>(dropped));
+                iov[count++] = iovec{line, static_cast<size_t>(length)};
+            }
+            while (count < BATCH_) {
+                const auto record = queue_.dequeue();
+                if (!record) {
+                    break;
+                }
+                char* line = &lines[count * LINE_BYTES_];
+                iov[count] = iovec{line, format_line(*record, line)};
+                ++count;
+            }
+            write_all(iov, count);
+            busy_.store(false, std::memory_order_seq_cst);
+
+            if (count == 0) {
+                if (stopping_.load(std::memory_order_acquire) && queue_.empty()) {
+                    return;
+                }
+                std::this_thread::sleep_for(IDLE_SLEEP_);
+            }
+        }
+    }
+
+    // writev() until everything is out; a short write resumes inside the iovec it stopped in
+    void write_all(iovec* iov, size_t count) {
+        while (count > 0) {
+            const ssize_t written = ::writev(fd_, iov, static_cast<int>(count));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;  // Nowhere to report the failure, give up on this batch
+            }
+            auto left = static_cast<size_t>(written);
+            while (count > 0 && left >= iov->iov_len) {
+                left -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+                iov->iov_len -= left;
+            }
+        }
+    }
+
+    const int fd_;
+    const OverflowPolicy policy_;
+    const LogLevel min_level_;
+    MPMCQueue<Record> queue_;
+    std::thread writer_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> busy_{false};
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<uint64_t> dropped_{0};
+    char pad0[CACHE_LINE_SIZE_ - sizeof(dropped_)]{};
+};
+
+}  // namespace lockfreekit
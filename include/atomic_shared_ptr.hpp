@@ -0,0 +1,234 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace lockfreekit {
+
+// Lock-free atomic std::shared_ptr using split reference counts (Williams, C++ Concurrency in Action 7.2.4),
+// for configuration objects that many workers read and that are swapped now and then. libstdc++'s
+// std::atomic<std::shared_ptr> serializes every access on an internal spinlock.
+//
+// The stored shared_ptr lives in a node. The atomic word holds the node pointer plus an external count: a load
+// bumps the external count with one CAS, which keeps the node alive while it copies the shared_ptr, then
+// gives its reference back. If the node is still current that is a CAS on the word again; if a store swapped
+// it out meanwhile, the store moved the external count into the node's internal count and the load decrements
+// that instead. Whoever brings the internal count to zero deletes the node.
+//
+// The external count shares the 64-bit word with the pointer (top 16 bits, above the 48-bit user address
+// space of x86-64 and AArch64), so a plain 64-bit CAS does the work of the double-width CAS the technique
+// usually needs: GCC only emits cmpxchg16b through libatomic.
+//
+// Every load still writes the shared word. Readers that look far more often than the value changes should go
+// through a SharedPtrCache, which only reads version().
+template <typename T>
+class AtomicSharedPtr {
+   public:
+    AtomicSharedPtr() noexcept = default;
+
+    explicit AtomicSharedPtr(std::shared_ptr<T> desired) : word_(pack(make_node(std::move(desired)), 0)) {}
+
+    ~AtomicSharedPtr() {
+        const uint64_t word = word_.load(std::memory_order_acquire);
+        if (Node* node = node_of(word)) {
+            retire(node, count_of(word));
+        }
+    }
+
+    [[nodiscard]] std::shared_ptr<T> load() const {
+        const uint64_t word = acquire_reference();
+        Node* node = node_of(word);
+        if (node == nullptr) {
+            return nullptr;
+        }
+        std::shared_ptr<T> value = node->value;
+        release_reference(node, word);
+        return value;
+    }
+
+    void store(std::shared_ptr<T> desired) { (void)exchange(std::move(desired)); }
+
+    std::shared_ptr<T> exchange(std::shared_ptr<T> desired) {
+        Node* fresh = make_node(std::move(desired));
+        const uint64_t old = word_.exchange(pack(fresh, 0), std::memory_order_acq_rel);
+        version_.fetch_add(1, std::memory_order_release);
+        Node* node = node_of(old);
+        if (node == nullptr) {
+            return nullptr;
+        }
+        std::shared_ptr<T> previous = node->value;  // Still ours: the word's reference was not released yet
+        retire(node, count_of(old));
+        return previous;
+    }
+
+    // Stores `desired` if the current value is `expected` (same pointer, same owner), else loads the current
+    // value into `expected`
+    bool compare_exchange_strong(std::shared_ptr<T>& expected, std::shared_ptr<T> desired) {
+        Node* fresh = nullptr;
+        for (;;) {
+            uint64_t word = acquire_reference();
+            Node* node = node_of(word);
+            const bool equal = node == nullptr ? expected == nullptr && !owned(expected) : same(node->value, expected);
+            if (!equal) {
+                expected = node != nullptr ? node->value : nullptr;
+                if (node != nullptr) {
+                    release_reference(node, word);
+                }
+                delete fresh;
+                return false;
+            }
+            if (fresh == nullptr && (desired != nullptr || owned(desired))) {
+                fresh = new Node{std::move(desired), {0}};
+                check_fits(fresh);
+            }
+            // Our own reference is part of the count the word hands over
+            while (node_of(word) == node) {
+                if (word_.compare_exchange_weak(word, pack(fresh, 0), std::memory_order_acq_rel,
+                                                std::memory_order_relaxed)) {
+                    version_.fetch_add(1, std::memory_order_release);
+                    if (node != nullptr) {
+                        retire(node, count_of(word) - 1);  // Hands over the others' references, drops ours
+                    }
+                    return true;
+                }
+            }
+            // Replaced under us: give our reference back to the node we held, then look again
+            if (node != nullptr) {
+                release_reference(node, word);
+            }
+        }
+    }
+
+    // Bumped by every store, exchange and successful compare_exchange
+    [[nodiscard]] uint64_t version() const noexcept { return version_.load(std::memory_order_acquire); }
+
+    [[nodiscard]] static constexpr bool is_lock_free() noexcept { return true; }
+
+    // Delete copy/move constructors and assignment operators
+    AtomicSharedPtr(const AtomicSharedPtr&) = delete;
+    AtomicSharedPtr& operator=(const AtomicSharedPtr&) = delete;
+    AtomicSharedPtr(AtomicSharedPtr&&) = delete;
+    AtomicSharedPtr& operator=(AtomicSharedPtr&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static constexpr int POINTER_BITS_ = 48;
+    static constexpr uint64_t POINTER_MASK_ = (uint64_t{1} << POINTER_BITS_) - 1;
+    static constexpr uint64_t ONE_REFERENCE_ = uint64_t{1} << POINTER_BITS_;
+    static constexpr uint64_t MAX_COUNT_ = (uint64_t{1} << (64 - POINTER_BITS_)) - 1;
+
+    static_assert(sizeof(void*) == sizeof(uint64_t), "AtomicSharedPtr packs pointers into 64-bit words");
+
+    struct Node {
+        std::shared_ptr<T> value;
+        std::atomic<int64_t> internal;  // Released references minus those handed over when it was replaced
+    };
+
+    static uint64_t pack(Node* node, uint64_t count) noexcept {
+        return reinterpret_cast<uint64_t>(node) | (count << POINTER_BITS_);
+    }
+    static Node* node_of(uint64_t word) noexcept { return reinterpret_cast<Node*>(word & POINTER_MASK_); }
+    static uint64_t count_of(uint64_t word) noexcept { return word >> POINTER_BITS_; }
+
+    // Holds a control block, even if it points at nothing (aliasing constructor)
+    static bool owned(const std::shared_ptr<T>& pointer) noexcept {
+        return !pointer.owner_before(std::shared_ptr<T>{}) && std::shared_ptr<T>{}.owner_before(pointer);
+    }
+    static bool same(const std::shared_ptr<T>& a, const std::shared_ptr<T>& b) noexcept {
+        return a.get() == b.get() && !a.owner_before(b) && !b.owner_before(a);
+    }
+
+    static void check_fits(Node* node) {
+        if ((reinterpret_cast<uint64_t>(node) & ~POINTER_MASK_) != 0) {
+            delete node;
+            throw std::runtime_error("AtomicSharedPtr node address does not fit in 48 bits");
+        }
+    }
+
+    // An empty shared_ptr is stored as a null node
+    static Node* make_node(std::shared_ptr<T> value) {
+        if (value == nullptr && !owned(value)) {
+            return nullptr;
+        }
+        Node* node = new Node{std::move(value), {0}};
+        check_fits(node);
+        return node;
+    }
+
+    // Adds one external reference to the current node (nothing if it is null); returns the word with it
+    uint64_t acquire_reference() const {
+        uint64_t word = word_.load(std::memory_order_relaxed);
+        for (;;) {
+            if (node_of(word) == nullptr) {
+                // Acquire: pairs with the store that emptied the word
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return word;
+            }
+            if (count_of(word) == MAX_COUNT_) {
+                std::this_thread::yield();  // 65535 loads in flight, wait for one to finish
+                word = word_.load(std::memory_order_relaxed);
+                continue;
+            }
+            // Acquire: pairs with the store that installed the node, so its value is visible
+            if (word_.compare_exchange_weak(word, word + ONE_REFERENCE_, std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+                return word + ONE_REFERENCE_;
+            }
+        }
+    }
+
+    // Gives back a reference acquire_reference() took on `node`
+    void release_reference(Node* node, uint64_t word) const {
+        while (node_of(word) == node) {
+            if (word_.compare_exchange_weak(word, word - ONE_REFERENCE_, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+                return;
+            }
+        }
+        // The node was replaced and our reference moved to its internal count
+        if (node->internal.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete node;
+        }
+    }
+
+    // Called once `node` left the word carrying `external` references: they now count against the node itself
+    static void retire(Node* node, uint64_t external) {
+        const auto handed_over = static_cast<int64_t>(external);
+        if (node->internal.fetch_add(handed_over, std::memory_order_acq_rel) + handed_over == 0) {
+            delete node;
+        }
+    }
+
+    alignas(CACHE_LINE_SIZE_) mutable std::atomic<uint64_t> word_{0};
+    char pad0[CACHE_LINE_SIZE_ - sizeof(word_)]{};
+    alignas(CACHE_LINE_SIZE_) std::atomic<uint64_t> version_{0};
+    char pad1[CACHE_LINE_SIZE_ - sizeof(version_)]{};
+};
+
+// A reader's cached copy of an AtomicSharedPtr's value. get() only reloads (and so only writes shared memory)
+// when the version changed, so readers of a value that rarely changes do not contend at all.
+template <typename T>
+class SharedPtrCache {
+   public:
+    const std::shared_ptr<T>& get(const AtomicSharedPtr<T>& source) {
+        const uint64_t version = source.version();
+        if (!loaded_ || version != version_) {
+            // A store between the two reads only makes us reload once more next time
+            value_ = source.load();
+            version_ = version;
+            loaded_ = true;
+        }
+        return value_;
+    }
+
+   private:
+    std::shared_ptr<T> value_;
+    uint64_t version_ = 0;
+    bool loaded_ = false;
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+#include "futex.hpp"
+#include "spin_wait.hpp"
+
+namespace lockfreekit {
+
+// Barriers for parallel phases and a latch for "start everyone at once". std::barrier funnels every arrival
+// through one counter; these spread arrivals over many cache lines.
+// - TreeBarrier: combining tree (Yew, Tzeng & Lawrie 1987). Participants arrive at small leaf counters; the
+//   last to arrive at a node carries on to its parent, and the one completing the root flips a global sense
+//   that releases everyone. O(fan_in) contention per counter, one broadcast line.
+// - DisseminationBarrier (Hensgen, Finkel & Manber 1988; Mellor-Crummey & Scott 1991): ceil(log2 n) rounds in
+//   which every participant signals a partner's flag and waits on its own. No counter and no broadcast line at
+//   all, every flag has one writer and one reader, but n log n flags.
+// - Latch: one-shot countdown, like std::latch.
+//
+// Both barriers use sense reversal, so they can be reused right away without a reset phase, and take the
+// participant's index (0 .. participants-1, one thread each) so that per-participant state needs no lookup.
+// Every wait spins for a while and then parks on a futex; a released thread that was still spinning reacts
+// within nanoseconds, one that parked costs its waker a syscall.
+
+// A cache line holding a small value that one side waits on and the other sets
+class BarrierFlag {
+   public:
+    static constexpr uint32_t SPINS_BEFORE_PARK = 256;
+
+    // Waits while the flag holds `value`
+    void wait_while(uint32_t value) noexcept {
+        uint32_t current = word_.load(std::memory_order_acquire);
+        for (uint32_t spins = 0; (current & ~PARKED_) == value;) {
+            if (spins < SPINS_BEFORE_PARK) {
+                ++spins;
+                cpu_relax();
+            } else if ((current & PARKED_) != 0 ||
+                       word_.compare_exchange_weak(current, current | PARKED_, std::memory_order_relaxed)) {
+                futex_wait(word_, value | PARKED_);
+            }
+            current = word_.load(std::memory_order_acquire);
+        }
+    }
+
+    // Release: the setter's writes happen before whatever the waiters do next
+    void set(uint32_t value) noexcept {
+        if ((word_.exchange(value, std::memory_order_release) & PARKED_) != 0) {
+            futex_wake(word_);
+        }
+    }
+
+    [[nodiscard]] uint32_t value() const noexcept { return word_.load(std::memory_order_acquire) & ~PARKED_; }
+
+   private:
+    static constexpr uint32_t PARKED_ = 1u << 31;  // Someone sleeps on the word
+
+    alignas(64) std::atomic<uint32_t> word_{0};
+};
+
+class TreeBarrier {
+   public:
+    static constexpr size_t DEFAULT_FAN_IN = 4;
+
+    explicit TreeBarrier(size_t participants, size_t fan_in = DEFAULT_FAN_IN)
+        : participant_count_(participants), fan_in_(fan_in) {
+        if (participant_count_ == 0 || fan_in_ < 2) {
+            throw std::invalid_argument("TreeBarrier needs participants > 0 and fan_in >= 2");
+        }
+        // Level sizes, leaves first, up to the single root
+        size_t nodes = 0;
+        for (size_t level = (participant_count_ + fan_in_ - 1) / fan_in_;; level = (level + fan_in_ - 1) / fan_in_) {
+            nodes += level;
+            if (level == 1) {
+                break;
+            }
+        }
+        nodes_ = std::make_unique<Node[]>(nodes);
+        participants_ = std::make_unique<Participant[]>(participant_count_);
+
+        size_t level_start = 0;
+        size_t children = participant_count_;  // Of the level being built
+        for (;;) {
+            const size_t level_size = (children + fan_in_ - 1) / fan_in_;
+            for (size_t i = 0; i < level_size; ++i) {
+                nodes_[level_start + i].expected =
+                    static_cast<uint32_t>(std::min(fan_in_, children - i * fan_in_));
+                if (level_size > 1) {
+                    nodes_[level_start + i].parent = &nodes_[level_start + level_size + i / fan_in_];
+                }
+            }
+            if (level_size == 1) {
+                break;
+            }
+            level_start += level_size;
+            children = level_size;
+        }
+    }
+
+    // Waits until all participants arrived in this phase
+    void arrive_and_wait(size_t participant) noexcept {
+        Participant& me = participants_[participant];
+        me.sense ^= 1;
+        Node* node = &nodes_[participant / fan_in_];
+        while (node != nullptr) {
+            // Acq_rel: the arrivals below chain up to whoever completes the root
+            if (node->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 != node->expected) {
+                release_.wait_while(me.sense ^ 1);
+                return;
+            }
+            // Last one here; nobody touches this node again before the release
+            node->arrived.store(0, std::memory_order_relaxed);
+            node = node->parent;
+        }
+        release_.set(me.sense);
+    }
+
+    [[nodiscard]] size_t participants() const noexcept { return participant_count_; }
+
+    // Delete copy/move constructors and assignment operators
+    TreeBarrier(const TreeBarrier&) = delete;
+    TreeBarrier& operator=(const TreeBarrier&) = delete;
+    TreeBarrier(TreeBarrier&&) = delete;
+    TreeBarrier& operator=(TreeBarrier&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+
+    struct alignas(CACHE_LINE_SIZE_) Node {
+        std::atomic<uint32_t> arrived{0};
+        uint32_t expected = 0;
+        Node* parent = nullptr;  // nullptr at the root
+    };
+
+    struct alignas(CACHE_LINE_SIZE_) Participant {
+        uint32_t sense = 0;  // Owner only: the sense of the phase it is in
+    };
+
+    const size_t participant_count_;
+    const size_t fan_in_;
+    std::unique_ptr<Node[]> nodes_;
+    std::unique_ptr<Participant[]> participants_;
+    BarrierFlag release_;
+};
+
+class DisseminationBarrier {
+   public:
+    explicit DisseminationBarrier(size_t participants)
+        : participant_count_(participants),
+          rounds_(participants > 1 ? static_cast<size_t>(std::bit_width(participants - 1)) : 0) {
+        if (participant_count_ == 0) {
+            throw std::invalid_argument("DisseminationBarrier needs participants > 0");
+        }
+        participants_ = std::make_unique<Participant[]>(participant_count_);
+        flags_ = std::make_unique<BarrierFlag[]>(participant_count_ * 2 * rounds_);
+    }
+
+    // Waits until all participants arrived in this phase
+    void arrive_and_wait(size_t participant) noexcept {
+        Participant& me = participants_[participant];
+        for (size_t round = 0; round < rounds_; ++round) {
+            const size_t partner = (participant + (size_t{1} << round)) % participant_count_;
+            flag(partner, me.parity, round).set(me.sense);
+            flag(participant, me.parity, round).wait_while(me.sense ^ 1);
+        }
+        // Flags alternate between two sets; the sense flips every other phase, when a set is used again
+        if (me.parity == 1) {
+            me.sense ^= 1;
+        }
+        me.parity ^= 1;
+    }
+
+    [[nodiscard]] size_t participants() const noexcept { return participant_count_; }
+
+    // Delete copy/move constructors and assignment operators
+    DisseminationBarrier(const DisseminationBarrier&) = delete;
+    DisseminationBarrier& operator=(const DisseminationBarrier&) = delete;
+    DisseminationBarrier(DisseminationBarrier&&) = delete;
+    DisseminationBarrier& operator=(DisseminationBarrier&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+
+    // Owner only
+    struct alignas(CACHE_LINE_SIZE_) Participant {
+        uint32_t parity = 0;
+        uint32_t sense = 1;
+    };
+
+    BarrierFlag& flag(size_t participant, uint32_t parity, size_t round) noexcept {
+        return flags_[(participant * 2 + parity) * rounds_ + round];
+    }
+
+    const size_t participant_count_;
+    const size_t rounds_;
+    std::unique_ptr<Participant[]> participants_;
+    std::unique_ptr<BarrierFlag[]> flags_;
+};
+
+class Latch {
+   public:
+    explicit Latch(uint32_t count) : count_(count) {
+        if (count == 0) {
+            released_.set(1);
+        }
+    }
+
+    // Release: the caller's writes happen before the waiters return
+    void count_down(uint32_t n = 1) noexcept {
+        if (count_.fetch_sub(n, std::memory_order_acq_rel) == n) {
+            released_.set(1);
+        }
+    }
+
+    void wait() noexcept { released_.wait_while(0); }
+
+    void arrive_and_wait(uint32_t n = 1) noexcept {
+        count_down(n);
+        wait();
+    }
+
+    [[nodiscard]] bool try_wait() const noexcept { return released_.value() == 1; }
+
+    // Delete copy/move constructors and assignment operators
+    Latch(const Latch&) = delete;
+    Latch& operator=(const Latch&) = delete;
+    Latch(Latch&&) = delete;
+    Latch& operator=(Latch&&) = delete;
+
+   private:
+    std::atomic<uint32_t> count_;
+    BarrierFlag released_;
+};
+
+}  // namespace lockfreekit
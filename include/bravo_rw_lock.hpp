@@ -0,0 +1,230 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "futex.hpp"
+#include "spin_wait.hpp"
+
+namespace lockfreekit {
+
+// Reader-writer lock for read-mostly data that cannot be made lock-free, after BRAVO (Dice & Kogan, "BRAVO:
+// Biased Locking for Reader-Writer Locks", USENIX ATC 2019). std::shared_mutex makes every reader write the
+// same counter; here a reader only writes a slot of its own.
+//
+// While the lock is reader-biased, lock_shared() increments the caller's slot, checks the bias is still on and
+// is done. A writer takes the underlying lock, revokes the bias and waits for every slot to drain. Readers
+// arriving meanwhile use the underlying lock like plain readers. Revoking costs a scan of all slots, so after
+// a revocation the bias stays off for BIAS_INHIBIT_FACTOR times as long as the scan took, and the first slow
+// reader after that turns it back on: write-heavy phases run on the underlying lock alone.
+//
+// The underlying lock is a single word (writer bit, parked bit, reader count) that prefers writers, spins
+// briefly and then parks on a futex. Threads are striped over slots by a sequential per-thread id, like
+// ShardedCounter's cells; threads sharing a slot only share its cache line.
+//
+// lock_shared() returns a token saying which path it took, for unlock_shared(); ReadLock does that pairing.
+class BravoRwLock {
+   public:
+    static constexpr uint32_t BIAS_INHIBIT_FACTOR = 9;
+
+    struct ReadToken {
+        uint32_t slot;  // SLOW_PATH_ if the reader holds the underlying lock
+    };
+
+    // `slots` is rounded up to a power of two; 0 means one per hardware thread
+    explicit BravoRwLock(size_t slots = 0)
+        : slot_count_(std::bit_ceil(slots > 0 ? slots : std::max<size_t>(std::thread::hardware_concurrency(), 1))),
+          slots_(std::make_unique<Slot[]>(slot_count_)) {}
+
+    [[nodiscard]] ReadToken lock_shared() noexcept {
+        if (reader_bias_.load(std::memory_order_relaxed)) {
+            const auto index = static_cast<uint32_t>(thread_stripe() & (slot_count_ - 1));
+            Slot& slot = slots_[index];
+            // Seq_cst pairs with the writer's revocation: either it sees our slot, or we see the bias gone
+            slot.readers.fetch_add(1, std::memory_order_seq_cst);
+            if (reader_bias_.load(std::memory_order_seq_cst)) {
+                return ReadToken{index};
+            }
+            slot.readers.fetch_sub(1, std::memory_order_release);
+        }
+        lock_shared_slow();
+        return ReadToken{SLOW_PATH_};
+    }
+
+    void unlock_shared(ReadToken token) noexcept {
+        if (token.slot != SLOW_PATH_) {
+            // Release: our reads happen before the writer that waits for the slot to drain
+            slots_[token.slot].readers.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+        const uint32_t old = state_.fetch_sub(1, std::memory_order_release);
+        if ((old & READERS_MASK_) == 1 && (old & PARKED_) != 0) {
+            wake_all();  // The last reader out lets a parked writer in
+        }
+    }
+
+    void lock() noexcept {
+        // Writer bit first: it stops new slow readers, so a stream of them cannot starve us
+        uint32_t state = state_.load(std::memory_order_relaxed);
+        for (uint32_t spins = 0;;) {
+            if ((state & WRITER_) == 0) {
+                if (state_.compare_exchange_weak(state, state | WRITER_, std::memory_order_acquire,
+                                                 std::memory_order_relaxed)) {
+                    break;
+                }
+                continue;
+            }
+            wait(state, spins);
+        }
+        for (uint32_t spins = 0; (state = state_.load(std::memory_order_acquire)) & READERS_MASK_;) {
+            wait(state, spins);
+        }
+        if (reader_bias_.load(std::memory_order_relaxed)) {
+            revoke_bias();
+        }
+    }
+
+    [[nodiscard]] bool try_lock() noexcept {
+        uint32_t expected = 0;
+        if (!state_.compare_exchange_strong(expected, WRITER_, std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+            return false;
+        }
+        if (reader_bias_.load(std::memory_order_relaxed)) {
+            // Waiting for the slots could block on the caller's own read lock: give up if any is busy
+            reader_bias_.store(false, std::memory_order_seq_cst);
+            for (size_t i = 0; i < slot_count_; ++i) {
+                // Seq_cst, as in revoke_bias()
+                if (slots_[i].readers.load(std::memory_order_seq_cst) != 0) {
+                    reader_bias_.store(true, std::memory_order_release);  // As in lock_shared_slow()
+                    unlock();
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void unlock() noexcept {
+        // No slow reader can hold the lock alongside us, so the count is 0
+        if ((state_.exchange(0, std::memory_order_release) & PARKED_) != 0) {
+            futex_wake(state_);
+        }
+    }
+
+    // Readers take the fast path right now
+    [[nodiscard]] bool reader_biased() const noexcept { return reader_bias_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] size_t slots() const noexcept { return slot_count_; }
+
+    // RAII shared ownership; std::unique_lock / std::lock_guard cover exclusive ownership
+    class ReadLock {
+       public:
+        explicit ReadLock(BravoRwLock& lock) noexcept : lock_(lock), token_(lock.lock_shared()) {}
+        ~ReadLock() { lock_.unlock_shared(token_); }
+
+        ReadLock(const ReadLock&) = delete;
+        ReadLock& operator=(const ReadLock&) = delete;
+
+       private:
+        BravoRwLock& lock_;
+        ReadToken token_;
+    };
+
+    // Delete copy/move constructors and assignment operators
+    BravoRwLock(const BravoRwLock&) = delete;
+    BravoRwLock& operator=(const BravoRwLock&) = delete;
+    BravoRwLock(BravoRwLock&&) = delete;
+    BravoRwLock& operator=(BravoRwLock&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static constexpr uint32_t SLOW_PATH_ = UINT32_MAX;
+    static constexpr uint32_t SPINS_BEFORE_PARK_ = 128;
+
+    static constexpr uint32_t WRITER_ = 1u << 31;
+    static constexpr uint32_t PARKED_ = 1u << 30;  // Someone sleeps on state_; the next release wakes everyone
+    static constexpr uint32_t READERS_MASK_ = PARKED_ - 1;
+
+    struct alignas(CACHE_LINE_SIZE_) Slot {
+        std::atomic<uint32_t> readers{0};
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    void lock_shared_slow() noexcept {
+        uint32_t state = state_.load(std::memory_order_relaxed);
+        for (uint32_t spins = 0;;) {
+            if ((state & WRITER_) == 0) {
+                if (state_.compare_exchange_weak(state, state + 1, std::memory_order_acquire,
+                                                 std::memory_order_relaxed)) {
+                    break;
+                }
+                continue;
+            }
+            wait(state, spins);
+        }
+        // Holding the lock shared, no writer is between revoking and unlocking: safe to turn the bias back on.
+        // Release: a fast reader that sees the bias also sees the last writer's data we acquired above.
+        if (!reader_bias_.load(std::memory_order_relaxed) &&
+            Clock::now().time_since_epoch().count() >= inhibit_until_.load(std::memory_order_relaxed)) {
+            reader_bias_.store(true, std::memory_order_release);
+        }
+    }
+
+    // Writer only, holding the underlying lock
+    void revoke_bias() noexcept {
+        const auto start = Clock::now();
+        reader_bias_.store(false, std::memory_order_seq_cst);
+        for (size_t i = 0; i < slot_count_; ++i) {
+            // Seq_cst against the fast readers' slot increment and bias recheck: either we see the slot taken, or
+            // the reader sees the bias gone and backs off. Also acquire, pairing with unlock_shared()'s release.
+            for (SpinWait spin; slots_[i].readers.load(std::memory_order_seq_cst) != 0; spin.wait()) {
+            }
+        }
+        const auto now = Clock::now();
+        inhibit_until_.store((now + (now - start) * BIAS_INHIBIT_FACTOR).time_since_epoch().count(),
+                             std::memory_order_relaxed);
+    }
+
+    // Spins a while on `state`, then parks until it changes; reloads it either way
+    void wait(uint32_t& state, uint32_t& spins) noexcept {
+        if (spins < SPINS_BEFORE_PARK_) {
+            ++spins;
+            cpu_relax();
+        } else if ((state & PARKED_) != 0 ||
+                   state_.compare_exchange_weak(state, state | PARKED_, std::memory_order_relaxed)) {
+            futex_wait(state_, state | PARKED_);
+        }
+        state = state_.load(std::memory_order_acquire);
+    }
+
+    void wake_all() noexcept {
+        if ((state_.fetch_and(~PARKED_, std::memory_order_relaxed) & PARKED_) != 0) {
+            futex_wake(state_);
+        }
+    }
+
+    // Sequential, so that the first threads land on distinct slots
+    static size_t thread_stripe() noexcept {
+        static std::atomic<size_t> next{0};
+        static thread_local const size_t stripe = next.fetch_add(1, std::memory_order_relaxed);
+        return stripe;
+    }
+
+    const size_t slot_count_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<bool> reader_bias_{true};  // Read by every reader, rarely written
+    std::atomic<int64_t> inhibit_until_{0};                            // Clock ticks
+    alignas(CACHE_LINE_SIZE_) std::atomic<uint32_t> state_{0};
+    char pad0[CACHE_LINE_SIZE_ - sizeof(state_)]{};
+};
+
+}  // namespace lockfreekit
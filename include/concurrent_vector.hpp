@@ -0,0 +1,160 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace lockfreekit {
+
+// Append-only vector for many concurrent writers (event logs). push_back() claims an index with one fetch_add
+// and constructs the element in place; elements never move, so references stay valid for the vector's
+// lifetime.
+//
+// Storage is a fixed table of segments, allocated on first use: segment k holds FIRST_SEGMENT << k elements,
+// so an index maps to its segment with a bit scan. Whoever first needs a segment allocates it and installs it
+// with a CAS (a loser frees its copy).
+//
+// size() is the published size: the longest prefix of indices whose elements are fully constructed. Writers
+// advance it past their own element and past any finished elements of slower writers behind it, so readers
+// never see a hole. A constructor that throws leaves its index, and so everything after it, unpublished.
+template <typename T>
+class ConcurrentVector {
+   public:
+    static constexpr size_t FIRST_SEGMENT = 64;
+
+    ConcurrentVector() = default;
+
+    ~ConcurrentVector() {
+        const size_t claimed = claimed_.load(std::memory_order_relaxed);
+        for (size_t k = 0; k < SEGMENTS_; ++k) {
+            Slot* segment = segments_[k].load(std::memory_order_relaxed);
+            if (segment == nullptr) {
+                continue;
+            }
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                const size_t first = segment_start(k);
+                for (size_t i = 0; i < segment_size(k) && first + i < claimed; ++i) {
+                    if (segment[i].ready.load(std::memory_order_relaxed)) {
+                        std::destroy_at(segment[i].value());
+                    }
+                }
+            }
+            delete[] segment;
+        }
+    }
+
+    // Returns the index of the new element
+    size_t push_back(const T& value) { return emplace_back(value); }
+    size_t push_back(T&& value) { return emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    size_t emplace_back(Args&&... args) {
+        const size_t index = claimed_.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slot_at(index, true);
+        std::construct_at(slot.value(), std::forward<Args>(args)...);
+        // Seq_cst, like the loads in publish(): of two writers finishing adjacent elements, either we see the
+        // next one ready while publishing, or its writer sees ours. The claim itself takes no part in this.
+        slot.ready.store(true, std::memory_order_seq_cst);
+        publish();
+        return index;
+    }
+
+    // Number of elements readers may access, a prefix of the claimed indices
+    [[nodiscard]] size_t size() const noexcept { return published_.load(std::memory_order_acquire); }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    // `index` must be below a size() this thread read, or an index push_back() returned to it
+    T& operator[](size_t index) noexcept { return *slot_at(index, false).value(); }
+    const T& operator[](size_t index) const noexcept {
+        return *const_cast<ConcurrentVector*>(this)->slot_at(index, false).value();
+    }
+
+    // Allocates the segments needed for `count` elements up front
+    void reserve(size_t count) {
+        for (size_t k = 0; k < SEGMENTS_ && segment_start(k) < count; ++k) {
+            (void)segment(k, true);
+        }
+    }
+
+    // Delete copy/move constructors and assignment operators
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+    ConcurrentVector(ConcurrentVector&&) = delete;
+    ConcurrentVector& operator=(ConcurrentVector&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static_assert((FIRST_SEGMENT & (FIRST_SEGMENT - 1)) == 0, "FIRST_SEGMENT must be a power of two");
+    static constexpr int FIRST_BITS_ = std::countr_zero(FIRST_SEGMENT);
+    // Enough segments to cover every index a size_t can hold
+    static constexpr size_t SEGMENTS_ = std::numeric_limits<size_t>::digits - FIRST_BITS_;
+
+    struct Slot {
+        std::atomic<bool> ready{false};
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    // Segment k covers [FIRST_SEGMENT * (2^k - 1), FIRST_SEGMENT * (2^(k+1) - 1))
+    static constexpr size_t segment_of(size_t index) noexcept {
+        return static_cast<size_t>(std::bit_width((index >> FIRST_BITS_) + 1)) - 1;
+    }
+    static constexpr size_t segment_start(size_t k) noexcept { return FIRST_SEGMENT * ((size_t{1} << k) - 1); }
+    static constexpr size_t segment_size(size_t k) noexcept { return FIRST_SEGMENT << k; }
+
+    // The segment, allocated if `allocate`; nullptr if it does not exist and `allocate` is false
+    Slot* segment(size_t k, bool allocate) {
+        Slot* current = segments_[k].load(std::memory_order_acquire);
+        if (current != nullptr || !allocate) {
+            return current;
+        }
+        Slot* fresh = new Slot[segment_size(k)];
+        if (segments_[k].compare_exchange_strong(current, fresh, std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+            return fresh;
+        }
+        delete[] fresh;  // Another writer installed it first
+        return current;
+    }
+
+    Slot& slot_at(size_t index, bool allocate) {
+        const size_t k = segment_of(index);
+        return segment(k, allocate)[index - segment_start(k)];
+    }
+
+    // Moves published_ over every ready element that follows it. Stops at the first slot that is not ready
+    // (or whose segment does not exist yet) rather than at claimed_: a relaxed claim says nothing about
+    // whether its writer has stored `ready`, while the seq_cst slot load is what the handoff with that
+    // writer relies on.
+    void publish() noexcept {
+        size_t published = published_.load(std::memory_order_seq_cst);
+        for (;;) {
+            const size_t k = segment_of(published);
+            Slot* current = segments_[k].load(std::memory_order_seq_cst);
+            if (current == nullptr || !current[published - segment_start(k)].ready.load(std::memory_order_seq_cst)) {
+                return;  // Its writer publishes it when done
+            }
+            // On failure `published` is reloaded and may already be past this element
+            if (published_.compare_exchange_weak(published, published + 1, std::memory_order_seq_cst)) {
+                ++published;
+            }
+        }
+    }
+
+    std::atomic<Slot*> segments_[SEGMENTS_]{};
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<size_t> claimed_{0};
+    char pad0[CACHE_LINE_SIZE_ - sizeof(claimed_)]{};
+    alignas(CACHE_LINE_SIZE_) std::atomic<size_t> published_{0};
+    char pad1[CACHE_LINE_SIZE_ - sizeof(published_)]{};
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+#include "mpmc_queue.hpp"
+#include "spin_wait.hpp"
+
+namespace lockfreekit {
+
+// MPSC queue that keeps only the latest update per key (market data: newest quote per instrument).
+//
+// Keys are dense ids in [0, keys). Every key has one entry holding its latest value behind a seqlock, and a
+// `pending` flag. push() overwrites the entry in place; only the push that finds the key not pending enqueues
+// the key id, so each key occupies at most one slot of the id ring, which therefore never fills up. pop()
+// returns distinct keys in the order they first became pending, each with its newest value.
+//
+// The consumer clears `pending` before reading the value: an update racing with pop() is either in the value
+// read, or re-queues the key (the consumer may then see the same value twice, never miss a newer one).
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::default_initializable<T>
+class ConflatingQueue {
+   public:
+    struct Update {
+        size_t key;
+        T value;
+    };
+
+    // The id ring is an MPMCQueue<uint32_t> of `keys` slots, which bounds `keys` (see its constructor)
+    explicit ConflatingQueue(size_t keys) : keys_(keys), entries_(std::make_unique<Entry[]>(keys)), ready_(keys) {}
+
+    // Any thread. Replaces the pending value of `key`, or queues the key if nothing is pending for it.
+    void push(size_t key, const T& value) {
+        Entry& entry = entries_[key];
+        write(entry, value);
+        // Pairs with the fence in pop(): either we see pending cleared and queue the key again, or the consumer
+        // reads our value
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (entry.pending.load(std::memory_order_relaxed) || entry.pending.exchange(true, std::memory_order_relaxed)) {
+            return;  // Conflated into the pending entry
+        }
+        for (SpinWait spin; !ready_.enqueue(static_cast<uint32_t>(key));) {
+            spin.wait();  // Only while the consumer is between taking a slot and releasing it
+        }
+    }
+
+    // Consumer only. The oldest pending key with its newest value.
+    [[nodiscard]] std::optional<Update> pop() {
+        const std::optional<uint32_t> key = ready_.dequeue();
+        if (!key) {
+            return std::nullopt;
+        }
+        Entry& entry = entries_[*key];
+        entry.pending.store(false, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return Update{*key, read(entry)};
+    }
+
+    // Number of keys with an update waiting
+    [[nodiscard]] size_t approx_size() const noexcept { return ready_.approx_size(); }
+
+    [[nodiscard]] bool empty() const noexcept { return ready_.empty(); }
+
+    [[nodiscard]] size_t key_count() const noexcept { return keys_; }
+
+    // Delete copy/move constructors and assignment operators
+    ConflatingQueue(const ConflatingQueue&) = delete;
+    ConflatingQueue& operator=(const ConflatingQueue&) = delete;
+    ConflatingQueue(ConflatingQueue&&) = delete;
+    ConflatingQueue& operator=(ConflatingQueue&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static constexpr size_t WORDS_ = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // The value is stored as relaxed atomic words so that a reader racing with a writer is not a data race; the
+    // seqlock tells it to retry.
+    struct alignas(CACHE_LINE_SIZE_) Entry {
+        std::atomic<uint32_t> sequence{0};  // Odd while a producer is writing
+        std::atomic<bool> pending{false};
+        std::atomic<uint64_t> words[WORDS_]{};
+    };
+
+    static void write(Entry& entry, const T& value) noexcept {
+        uint64_t words[WORDS_]{};
+        std::memcpy(words, &value, sizeof(T));
+        // Producers updating the same key take turns by making the sequence odd
+        uint32_t sequence = entry.sequence.load(std::memory_order_relaxed);
+        for (SpinWait spin;;) {
+            if ((sequence & 1) == 0 && entry.sequence.compare_exchange_weak(sequence, sequence + 1,
+                                                                            std::memory_order_relaxed)) {
+                break;
+            }
+            spin.wait();
+            sequence = entry.sequence.load(std::memory_order_relaxed);
+        }
+        // Release fence: a reader that sees any of the new words also sees the odd sequence
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS_; ++i) {
+            entry.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        entry.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    static T read(const Entry& entry) noexcept {
+        uint64_t words[WORDS_];
+        for (SpinWait spin;; spin.wait()) {
+            const uint32_t before = entry.sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0) {
+                continue;
+            }
+            for (size_t i = 0; i < WORDS_; ++i) {
+                words[i] = entry.words[i].load(std::memory_order_relaxed);
+            }
+            // Acquire fence: the words are read before the sequence is checked again
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (entry.sequence.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    const size_t keys_;
+    std::unique_ptr<Entry[]> entries_;
+    MPMCQueue<uint32_t> ready_;  // Ids of the pending keys, in first-arrival order
+};
+
+}  // namespace lockfreekit
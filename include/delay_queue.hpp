@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "futex.hpp"
+#include "mpmc_queue.hpp"
+#include "spin_wait.hpp"
+#include "timing_wheel.hpp"
+
+namespace lockfreekit {
+
+// Concurrent delay queue: items become visible to consumers only once their deadline has passed (retries,
+// timeouts).
+//
+// Producers push lock-free into a bounded MPMCQueue staging ring. Consumers take turns as the timekeeper: the
+// one holding the timekeeper flag moves staged items into a hierarchical timing wheel, advances the wheel to
+// the current time and moves due items into a ready ring that every consumer dequeues from. A consumer with
+// nothing to do parks until the earliest deadline the wheel knows of; a producer wakes it early only if its
+// item is due before that.
+//
+// Deadlines are rounded up to the wheel resolution, so an item is never released early and at most one
+// resolution late (plus scheduling delay).
+template <typename T>
+requires QueueValue<T>
+class DelayQueue {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    // `capacity` bounds the staging ring and the ready ring; the wheel itself grows as needed
+    explicit DelayQueue(size_t capacity, Clock::duration resolution = std::chrono::milliseconds(1))
+        : staging_(capacity), ready_(capacity), resolution_(resolution), origin_(Clock::now()) {
+        if (resolution_.count() <= 0) {
+            throw std::invalid_argument("DelayQueue resolution must be > 0");
+        }
+    }
+
+    // Any thread. Returns false if the staging ring is full.
+    [[nodiscard]] bool push_at(Clock::time_point deadline, const T& value) {
+        const uint64_t tick = tick_at(deadline);
+        if (!staging_.enqueue(Staged{tick, value})) {
+            return false;
+        }
+        // Pairs with the fence in park(): either we see the sleeper, or it sees our item in the staging ring
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) > 0 && tick < next_tick_.load(std::memory_order_relaxed)) {
+            epoch_.fetch_add(1, std::memory_order_release);
+            futex_wake(epoch_, 1);
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool push_after(Clock::duration delay, const T& value) {
+        return push_at(Clock::now() + delay, value);
+    }
+
+    // An item whose deadline has passed, or nullopt
+    [[nodiscard]] std::optional<T> try_pop() {
+        if (auto value = ready_.dequeue()) {
+            return value;
+        }
+        if (try_keep_time() == BUSY_) {
+            return std::nullopt;
+        }
+        return ready_.dequeue();
+    }
+
+    // Waits until an item is due. Returns nullopt once close() was called and no due item is left; items that
+    // are not due yet at that point are dropped.
+    [[nodiscard]] std::optional<T> pop() {
+        for (SpinWait spin;;) {
+            if (auto value = ready_.dequeue()) {
+                return value;
+            }
+            if (closed_.load(std::memory_order_acquire)) {
+                // Due items may still sit in staging or in the wheel: one timekeeping pass moves them over first
+                if (try_keep_time() == BUSY_) {
+                    spin.wait();
+                    continue;
+                }
+                return ready_.dequeue();
+            }
+            const uint32_t epoch = epoch_.load(std::memory_order_acquire);
+            const uint64_t next_tick = try_keep_time();
+            if (next_tick == BUSY_) {
+                spin.wait();  // Another consumer is the timekeeper, it is done shortly
+                continue;
+            }
+            if (ready_.empty()) {
+                park(epoch, next_tick);
+            }
+        }
+    }
+
+    // Wakes every consumer; pop() returns nullopt from now on when nothing is due
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        epoch_.fetch_add(1, std::memory_order_release);
+        futex_wake(epoch_);
+    }
+
+    // Delete copy/move constructors and assignment operators
+    DelayQueue(const DelayQueue&) = delete;
+    DelayQueue& operator=(const DelayQueue&) = delete;
+    DelayQueue(DelayQueue&&) = delete;
+    DelayQueue& operator=(DelayQueue&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static constexpr uint64_t NEVER_ = HierarchicalWheel::NEVER;
+    static constexpr uint64_t BUSY_ = NEVER_ - 1;
+
+    struct Staged {
+        uint64_t tick = 0;
+        T value{};
+    };
+
+    struct Node {
+        uint64_t tick = 0;
+        T value{};
+        uint32_t next = HierarchicalWheel::NIL;
+    };
+
+    // Ceiling, so that a deadline between two ticks is released at the later one
+    uint64_t tick_at(Clock::time_point time) const noexcept {
+        const auto since = time - origin_;
+        if (since.count() <= 0) {
+            return 0;
+        }
+        return static_cast<uint64_t>((since + resolution_ - Clock::duration(1)) / resolution_);
+    }
+
+    // Floor: the last tick that has fully started
+    uint64_t current_tick() const noexcept { return static_cast<uint64_t>((Clock::now() - origin_) / resolution_); }
+
+    // Runs one timekeeping round if no other consumer is. Returns the next wheel event tick, NEVER_ if the wheel
+    // is empty, or BUSY_ if another consumer holds the flag.
+    uint64_t try_keep_time() {
+        if (timekeeper_.exchange(true, std::memory_order_acquire)) {
+            return BUSY_;
+        }
+        size_t released = flush_due();
+        while (auto staged = staging_.dequeue()) {
+            insert(staged->tick, std::move(staged->value));
+        }
+        advance(current_tick());
+        released += flush_due();
+        const uint64_t next_tick = due_.empty() ? wheel_.next_event_tick() : wheel_.current_tick();
+        next_tick_.store(next_tick, std::memory_order_relaxed);
+        timekeeper_.store(false, std::memory_order_release);
+
+        // We take one of the released items ourselves, the others are for parked consumers
+        if (released > 1 && sleepers_.load(std::memory_order_relaxed) > 0) {
+            epoch_.fetch_add(1, std::memory_order_release);
+            futex_wake(epoch_, static_cast<int>(std::min<size_t>(released - 1, INT_MAX)));
+        }
+        return next_tick;
+    }
+
+    void park(uint32_t epoch, uint64_t next_tick) {
+        sleepers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (staging_.empty() && ready_.empty() && !closed_.load(std::memory_order_acquire)) {
+            if (next_tick == NEVER_) {
+                futex_wait(epoch_, epoch);
+            } else {
+                const Clock::time_point wake_at = origin_ + resolution_ * static_cast<int64_t>(next_tick);
+                futex_wait(epoch_, epoch, wake_at - Clock::now());
+            }
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Moves due items into the ready ring until it is full; returns how many it moved
+    size_t flush_due() {
+        size_t moved = 0;
+        while (!due_.empty() && ready_.enqueue(due_.front())) {
+            due_.pop_front();
+            ++moved;
+        }
+        return moved;
+    }
+
+    // --- Timing wheel, only touched by the timekeeper ---
+
+    void insert(uint64_t tick, T&& value) {
+        if (tick <= wheel_.current_tick()) {
+            due_.push_back(std::move(value));
+            return;
+        }
+        uint32_t index = free_;
+        if (index != HierarchicalWheel::NIL) {
+            free_ = nodes_[index].next;
+        } else {
+            index = static_cast<uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        nodes_[index].tick = tick;
+        nodes_[index].value = std::move(value);
+        file(index);
+    }
+
+    // Files a node in the wheel, or releases it if it is due
+    void file(uint32_t index) {
+        if (!wheel_.place(index, node_at())) {
+            due_.push_back(std::move(nodes_[index].value));
+            nodes_[index].value = T{};
+            nodes_[index].next = free_;
+            free_ = index;
+        }
+    }
+
+    void advance(uint64_t now) {
+        wheel_.advance(now, node_at(), [this](uint32_t index) { file(index); });
+    }
+
+    // `nodes_` may grow, so the wheel reaches nodes through their index
+    auto node_at() noexcept {
+        return [this](uint32_t index) -> Node& { return nodes_[index]; };
+    }
+
+    MPMCQueue<Staged> staging_;
+    MPMCQueue<T> ready_;
+    const Clock::duration resolution_;
+    const Clock::time_point origin_;
+    std::atomic<bool> closed_{false};
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<bool> timekeeper_{false};
+    HierarchicalWheel wheel_;
+    std::vector<Node> nodes_;
+    uint32_t free_ = HierarchicalWheel::NIL;
+    std::deque<T> due_;  // Released by the wheel, waiting for room in ready_
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<uint32_t> sleepers_{0};
+    std::atomic<uint32_t> epoch_{0};
+    std::atomic<uint64_t> next_tick_{NEVER_};
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <thread>
+
+#include "mpmc_queue.hpp"
+#include "spin_wait.hpp"
+
+namespace lockfreekit {
+
+// MPMCQueue with an elimination layer for the low-occupancy case (Moir, Nussbaum, Shalev, Shavit).
+//
+// A consumer that finds the ring empty advertises itself in an exchanger slot and waits briefly. A producer that
+// sees a waiting consumer while the ring is empty hands its element over directly, without touching head_/tail_.
+//
+// FIFO argument: the producer only hands off after observing the ring empty, at a moment when the consumer is
+// already waiting (its failed dequeue saw the ring empty too, before it advertised). Both operations are in
+// progress at that moment, so the pair linearizes there as enqueue(x) immediately followed by dequeue() == x on an
+// empty queue, which cannot overtake any other element.
+template <typename T, size_t static_capacity = 0, typename Index = size_t>
+requires QueueValue<T> && QueueIndex<Index>
+class EliminationQueue {
+   public:
+    static constexpr size_t DEFAULT_ELIMINATION_SPINS = 256;
+
+    // `elimination_spins` bounds how long an empty dequeue() waits for a handoff; 0 disables elimination.
+    explicit EliminationQueue(size_t capacity, size_t elimination_spins = DEFAULT_ELIMINATION_SPINS)
+        requires(static_capacity == 0)
+        : queue_(capacity), elimination_spins_(elimination_spins) {}
+
+    explicit EliminationQueue(size_t elimination_spins = DEFAULT_ELIMINATION_SPINS) requires(static_capacity > 0)
+        : elimination_spins_(elimination_spins) {}
+
+    [[nodiscard]] bool enqueue(const T& value) {
+        if (waiting_.load(std::memory_order_relaxed) > 0 && try_hand_off(value)) {
+            return true;
+        }
+        return queue_.enqueue(value);
+    }
+
+    // Like MPMCQueue::dequeue(), but on an empty queue waits up to `elimination_spins` for a producer to
+    // hand an element over before giving up.
+    [[nodiscard]] std::optional<T> dequeue() {
+        if (auto value = queue_.dequeue()) {
+            return value;
+        }
+        if (elimination_spins_ == 0) {
+            return std::nullopt;
+        }
+        Exchanger* exchanger = advertise();
+        if (exchanger == nullptr) {
+            return queue_.dequeue();  // Every slot has a waiter already
+        }
+
+        waiting_.fetch_add(1, std::memory_order_relaxed);
+        SpinWait spin;
+        for (size_t i = 0; i < elimination_spins_; ++i) {
+            // Stop waiting as soon as the ring has something, the producer may not hand off anymore
+            if (exchanger->state.load(std::memory_order_relaxed) != WAITING_ || !queue_.empty()) {
+                break;
+            }
+            spin.wait();
+        }
+        waiting_.fetch_sub(1, std::memory_order_relaxed);
+
+        uint32_t expected = WAITING_;
+        if (exchanger->state.compare_exchange_strong(expected, FREE_, std::memory_order_relaxed)) {
+            return queue_.dequeue();  // Withdrew without a handoff
+        }
+        // A producer claimed the slot. It is between its CAS and the store of the value, just like an
+        // MPMCQueue producer between its tail_ CAS and the sequence store.
+        spin.reset();
+        while (exchanger->state.load(std::memory_order_acquire) != DONE_) {
+            spin.wait();
+        }
+        T value = std::move(exchanger->value);
+        exchanger->state.store(FREE_, std::memory_order_release);
+        return value;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return queue_.empty(); }
+
+    [[nodiscard]] size_t approx_size() const noexcept { return queue_.approx_size(); }
+
+    [[nodiscard]] constexpr size_t capacity() const noexcept { return queue_.capacity(); }
+
+    // Delete copy/move constructors and assignment operators
+    EliminationQueue(const EliminationQueue&) = delete;
+    EliminationQueue& operator=(const EliminationQueue&) = delete;
+    EliminationQueue(EliminationQueue&&) = delete;
+    EliminationQueue& operator=(EliminationQueue&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static constexpr size_t ELIMINATION_SLOTS_ = 16;
+
+    static constexpr uint32_t FREE_ = 0;
+    static constexpr uint32_t WAITING_ = 1;  // A consumer is advertised
+    static constexpr uint32_t BUSY_ = 2;     // A producer claimed the consumer and is writing the value
+    static constexpr uint32_t DONE_ = 3;     // The value is ready for the consumer
+
+    struct alignas(CACHE_LINE_SIZE_) Exchanger {
+        std::atomic<uint32_t> state{FREE_};
+        T value{};
+    };
+
+    // Spreads threads over the exchanger slots
+    static size_t thread_hint() noexcept {
+        static thread_local const size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        return hint;
+    }
+
+    Exchanger* advertise() noexcept {
+        const size_t start = thread_hint();
+        for (size_t i = 0; i < ELIMINATION_SLOTS_; ++i) {
+            Exchanger& exchanger = exchangers_[(start + i) % ELIMINATION_SLOTS_];
+            uint32_t expected = FREE_;
+            // Relaxed is enough: the previous consumer's release-store of FREE_ heads a release sequence that
+            // our RMW continues, so a producer acquiring the slot still synchronizes with that consumer.
+            if (exchanger.state.compare_exchange_strong(expected, WAITING_, std::memory_order_relaxed)) {
+                return &exchanger;
+            }
+        }
+        return nullptr;
+    }
+
+    bool try_hand_off(const T& value) {
+        const size_t start = thread_hint();
+        for (size_t i = 0; i < ELIMINATION_SLOTS_; ++i) {
+            Exchanger& exchanger = exchangers_[(start + i) % ELIMINATION_SLOTS_];
+            uint32_t state = exchanger.state.load(std::memory_order_relaxed);
+            if (state != WAITING_) {
+                continue;
+            }
+            // The linearization point: the ring must be empty while the consumer is waiting
+            if (!queue_.empty()) {
+                return false;
+            }
+            if (exchanger.state.compare_exchange_strong(state, BUSY_, std::memory_order_acquire,
+                                                        std::memory_order_relaxed)) {
+                exchanger.value = value;
+                exchanger.state.store(DONE_, std::memory_order_release);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    MPMCQueue<T, static_capacity, Index> queue_;
+    const size_t elimination_spins_;
+
+    Exchanger exchangers_[ELIMINATION_SLOTS_];
+    alignas(CACHE_LINE_SIZE_) std::atomic<size_t> waiting_{0};
+    char pad0[CACHE_LINE_SIZE_ - sizeof(waiting_)]{};
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace lockfreekit {
+
+// Bump-pointer arena for short-lived message payloads, owned by one producer thread (typically a thread_local
+// per producer). Allocation is a pointer bump; memory is reclaimed a whole epoch at a time, in O(1) per chunk,
+// instead of one delete per message.
+//
+// The owner allocates into the current epoch and closes it with advance_epoch() (say once per pipeline pass).
+// Whoever is done with an allocation calls release(epoch) from any thread; the message carries the epoch it
+// was allocated in. A closed epoch whose allocations have all been released is reset: its chunks go back to the
+// arena's free list. Releases are counted rather than tracked per consumer, so no consumer has to register,
+// and an idle consumer or a message still sitting in a queue can never be mistaken for "done".
+//
+// The release counters are striped over cache lines so that consumers releasing into the same epoch do not
+// contend. Nothing is destroyed on reset: only trivially destructible objects belong in the arena.
+class EpochArena {
+   public:
+    using Epoch = uint64_t;
+
+    static constexpr size_t DEFAULT_CHUNK_BYTES = 64 * 1024;
+    // Largest alignment allocate() supports
+    static constexpr size_t MAX_ALIGN = 64;
+
+    explicit EpochArena(size_t chunk_bytes = DEFAULT_CHUNK_BYTES) : chunk_bytes_(chunk_bytes) {
+        if (chunk_bytes_ < MAX_ALIGN) {
+            throw std::invalid_argument("EpochArena chunk size must be >= 64 bytes");
+        }
+        slots_[0].open = true;
+    }
+
+    // Outstanding allocations die with the arena
+    ~EpochArena() {
+        for (auto& slot : slots_) {
+            free_list(slot.chunks);
+        }
+        free_list(free_);
+    }
+
+    // Owner only. `align` must be a power of two no larger than MAX_ALIGN.
+    [[nodiscard]] void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        if (align == 0 || (align & (align - 1)) != 0 || align > MAX_ALIGN) {
+            throw std::invalid_argument("EpochArena alignment must be a power of two <= 64");
+        }
+        bytes = std::max<size_t>(bytes, 1);
+        EpochSlot& slot = current_slot();
+        Chunk* chunk = slot.chunks;
+        size_t offset = chunk != nullptr ? align_up(chunk->used, align) : 0;
+        if (chunk == nullptr || offset + bytes > chunk->size) {
+            chunk = take_chunk(bytes);
+            chunk->next = slot.chunks;
+            slot.chunks = chunk;
+            offset = 0;
+        }
+        chunk->used = offset + bytes;
+        ++slot.allocated;
+        return chunk->data() + offset;
+    }
+
+    // Owner only
+    template <typename T, typename... Args>
+    requires std::is_trivially_destructible_v<T>
+    [[nodiscard]] T* create(Args&&... args) {
+        return ::new (allocate(sizeof(T), alignof(T))) T{std::forward<Args>(args)...};
+    }
+
+    // Owner only. The epoch new allocations belong to.
+    [[nodiscard]] Epoch epoch() const noexcept { return epoch_; }
+
+    // Owner only. Closes the current epoch and opens the next one, resetting released epochs first. Returns false
+    // if every epoch slot is still waiting for releases; allocation then carries on in the current epoch.
+    bool advance_epoch() {
+        collect();
+        EpochSlot& next = slots_[(epoch_ + 1) % EPOCH_SLOTS_];
+        if (next.open || next.chunks != nullptr) {
+            return false;
+        }
+        current_slot().open = false;
+        ++epoch_;
+        next.open = true;
+        return true;
+    }
+
+    // Any thread. `count` allocations of `epoch` will not be touched again.
+    void release(Epoch epoch, uint64_t count = 1) noexcept {
+        EpochSlot& slot = slots_[epoch % EPOCH_SLOTS_];
+        // Release: our last use of the memory happens before the owner reuses it
+        slot.released[thread_stripe() % STRIPES_].count.fetch_add(count, std::memory_order_release);
+    }
+
+    // Owner only. Resets every closed epoch whose allocations were all released; returns how many it reset.
+    size_t collect() noexcept {
+        size_t reset = 0;
+        for (auto& slot : slots_) {
+            if (slot.open || slot.chunks == nullptr) {
+                continue;
+            }
+            uint64_t released = 0;
+            // A stale count is only ever too low, which just postpones the reset
+            for (auto& stripe : slot.released) {
+                released += stripe.count.load(std::memory_order_acquire);
+            }
+            if (released != slot.allocated) {
+                continue;
+            }
+            for (auto& stripe : slot.released) {
+                stripe.count.store(0, std::memory_order_relaxed);
+            }
+            slot.allocated = 0;
+            recycle(slot.chunks);
+            slot.chunks = nullptr;
+            ++reset;
+        }
+        return reset;
+    }
+
+    // Owner only. Closed epochs still waiting for releases.
+    [[nodiscard]] size_t pending_epochs() const noexcept {
+        return static_cast<size_t>(
+            std::count_if(std::begin(slots_), std::end(slots_), [](const EpochSlot& slot) {
+                return !slot.open && slot.chunks != nullptr;
+            }));
+    }
+
+    // Owner only. Chunk memory the arena holds, in use or free.
+    [[nodiscard]] size_t reserved_bytes() const noexcept { return reserved_bytes_; }
+
+    // Delete copy/move constructors and assignment operators
+    EpochArena(const EpochArena&) = delete;
+    EpochArena& operator=(const EpochArena&) = delete;
+    EpochArena(EpochArena&&) = delete;
+    EpochArena& operator=(EpochArena&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static constexpr Epoch EPOCH_SLOTS_ = 8;  // Epochs that can wait for releases at once, the current one included
+    static constexpr size_t STRIPES_ = 8;
+
+    // The header is padded to MAX_ALIGN so that data() is aligned like the chunk itself
+    struct alignas(MAX_ALIGN) Chunk {
+        Chunk* next = nullptr;
+        size_t size = 0;  // Usable bytes
+        size_t used = 0;
+
+        std::byte* data() noexcept { return reinterpret_cast<std::byte*>(this + 1); }
+    };
+
+    struct alignas(CACHE_LINE_SIZE_) Stripe {
+        std::atomic<uint64_t> count{0};
+    };
+
+    struct EpochSlot {
+        Stripe released[STRIPES_];  // Written by consumers
+        // Owner only
+        Chunk* chunks = nullptr;  // The chunk being filled first
+        uint64_t allocated = 0;
+        bool open = false;
+    };
+
+    static size_t align_up(size_t offset, size_t align) noexcept { return (offset + align - 1) & ~(align - 1); }
+
+    EpochSlot& current_slot() noexcept { return slots_[epoch_ % EPOCH_SLOTS_]; }
+
+    // A pooled chunk, or a dedicated one for an allocation larger than a chunk
+    Chunk* take_chunk(size_t bytes) {
+        if (bytes <= chunk_bytes_ && free_ != nullptr) {
+            Chunk* chunk = free_;
+            free_ = chunk->next;
+            chunk->used = 0;
+            return chunk;
+        }
+        const size_t size = std::max(bytes, chunk_bytes_);
+        void* memory = ::operator new(sizeof(Chunk) + size, std::align_val_t{MAX_ALIGN});
+        reserved_bytes_ += size;
+        Chunk* chunk = ::new (memory) Chunk;
+        chunk->size = size;
+        return chunk;
+    }
+
+    // Pools the regular chunks of a list and frees the oversized ones
+    void recycle(Chunk* chunk) noexcept {
+        while (chunk != nullptr) {
+            Chunk* next = chunk->next;
+            if (chunk->size == chunk_bytes_) {
+                chunk->next = free_;
+                free_ = chunk;
+            } else {
+                reserved_bytes_ -= chunk->size;
+                ::operator delete(chunk, std::align_val_t{MAX_ALIGN});
+            }
+            chunk = next;
+        }
+    }
+
+    static void free_list(Chunk* chunk) noexcept {
+        while (chunk != nullptr) {
+            Chunk* next = chunk->next;
+            ::operator delete(chunk, std::align_val_t{MAX_ALIGN});
+            chunk = next;
+        }
+    }
+
+    // Sequential, so that the first threads land on distinct stripes
+    static size_t thread_stripe() noexcept {
+        static std::atomic<size_t> next{0};
+        static thread_local const size_t stripe = next.fetch_add(1, std::memory_order_relaxed);
+        return stripe;
+    }
+
+    const size_t chunk_bytes_;
+    Epoch epoch_ = 0;
+    EpochSlot slots_[EPOCH_SLOTS_];
+    Chunk* free_ = nullptr;
+    size_t reserved_bytes_ = 0;
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "mpmc_queue.hpp"
+#include "spin_wait.hpp"
+
+namespace lockfreekit {
+
+// Bounded MPMC queue using flat combining (Hendler, Incze, Shavit, Tzafrir).
+//
+// Threads publish their operation in a per-thread record. Whoever grabs the combiner lock applies every pending
+// request to a plain sequential ring and writes the results back, while the others spin on their own record.
+// Under heavy contention this replaces a storm of CAS retries on head_/tail_ with one cache-friendly pass.
+template <typename T>
+requires QueueValue<T>
+class FlatCombiningQueue {
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+
+   public:
+    class Handle {
+       public:
+        Handle() = default;
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+       private:
+        friend class FlatCombiningQueue;
+
+        // Written by the owner to publish a request, reset to NONE by the combiner once it is served
+        alignas(CACHE_LINE_SIZE_) std::atomic<uint32_t> request_{NONE_};
+        T value_{};
+        bool success_ = false;
+    };
+
+    FlatCombiningQueue(size_t capacity, size_t max_threads)
+        : capacity_(capacity),
+          max_threads_(max_threads),
+          buffer_(capacity),
+          handles_(max_threads > 0 ? std::make_unique<Handle[]>(max_threads) : nullptr) {
+        if (capacity_ < 1) {
+            throw std::invalid_argument("Queue capacity must be > 0");
+        }
+        if (max_threads_ < 1) {
+            throw std::invalid_argument("Queue max_threads must be > 0");
+        }
+    }
+
+    // Hands out one of the `max_threads` publication records. A handle must not be shared between threads.
+    [[nodiscard]] Handle& register_thread() {
+        const size_t index = registered_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= max_threads_) {
+            throw std::length_error("FlatCombiningQueue: more threads registered than max_threads");
+        }
+        return handles_[index];
+    }
+
+    [[nodiscard]] bool enqueue(Handle& handle, const T& value) {
+        handle.value_ = value;
+        publish(handle, ENQUEUE_);
+        return handle.success_;
+    }
+
+    [[nodiscard]] std::optional<T> dequeue(Handle& handle) {
+        publish(handle, DEQUEUE_);
+        if (!handle.success_) {
+            return std::nullopt;
+        }
+        return std::move(handle.value_);
+    }
+
+    [[nodiscard]] size_t approx_size() const noexcept { return size_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+    // Delete copy/move constructors and assignment operators
+    FlatCombiningQueue(const FlatCombiningQueue&) = delete;
+    FlatCombiningQueue& operator=(const FlatCombiningQueue&) = delete;
+    FlatCombiningQueue(FlatCombiningQueue&&) = delete;
+    FlatCombiningQueue& operator=(FlatCombiningQueue&&) = delete;
+
+   private:
+    static constexpr uint32_t NONE_ = 0;
+    static constexpr uint32_t ENQUEUE_ = 1;
+    static constexpr uint32_t DEQUEUE_ = 2;
+
+    // Extra scans of the records per combining session, to pick up requests that arrive while we combine
+    static constexpr int COMBINE_PASSES_ = 2;
+
+    void publish(Handle& handle, uint32_t op) {
+        // Release makes value_ visible to the combiner that picks up the request
+        handle.request_.store(op, std::memory_order_release);
+
+        for (SpinWait spin;;) {
+            if (!combiner_lock_.load(std::memory_order_relaxed) &&
+                !combiner_lock_.exchange(true, std::memory_order_acquire)) {
+                // Our own record was published before we took the lock, so this pass serves it too
+                combine();
+                combiner_lock_.store(false, std::memory_order_release);
+                return;
+            }
+            // Acquire pairs with the combiner's release-store, making value_/success_ visible
+            while (handle.request_.load(std::memory_order_acquire) != NONE_) {
+                if (!combiner_lock_.load(std::memory_order_relaxed)) {
+                    break;  // The combiner left without serving us; try to take over
+                }
+                spin.wait();
+            }
+            if (handle.request_.load(std::memory_order_acquire) == NONE_) {
+                return;
+            }
+        }
+    }
+
+    void combine() {
+        const size_t records = std::min(registered_.load(std::memory_order_relaxed), max_threads_);
+        for (int pass = 0; pass < COMBINE_PASSES_; ++pass) {
+            bool served = false;
+            for (size_t i = 0; i < records; ++i) {
+                Handle& handle = handles_[i];
+                const uint32_t op = handle.request_.load(std::memory_order_acquire);
+                if (op == NONE_) {
+                    continue;
+                }
+                if (op == ENQUEUE_) {
+                    handle.success_ = push(std::move(handle.value_));
+                } else {
+                    handle.success_ = pop(handle.value_);
+                }
+                handle.request_.store(NONE_, std::memory_order_release);
+                served = true;
+            }
+            if (!served) {
+                break;
+            }
+        }
+        size_.store(tail_ - head_, std::memory_order_relaxed);
+    }
+
+    // The ring itself is only ever touched by the thread holding combiner_lock_
+    bool push(T&& value) {
+        if (tail_ - head_ == capacity_) {
+            return false;  // Full
+        }
+        buffer_[tail_ % capacity_] = std::move(value);
+        ++tail_;
+        return true;
+    }
+
+    bool pop(T& value) {
+        if (tail_ == head_) {
+            return false;  // Empty
+        }
+        value = std::move(buffer_[head_ % capacity_]);
+        ++head_;
+        return true;
+    }
+
+    const size_t capacity_;
+    const size_t max_threads_;
+    std::vector<T> buffer_;
+    size_t head_ = 0;
+    size_t tail_ = 0;
+    std::unique_ptr<Handle[]> handles_;
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<size_t> registered_{0};
+    alignas(CACHE_LINE_SIZE_) std::atomic<bool> combiner_lock_{false};
+    char pad0[CACHE_LINE_SIZE_ - sizeof(combiner_lock_)]{};
+    alignas(CACHE_LINE_SIZE_) std::atomic<size_t> size_{0};
+    char pad1[CACHE_LINE_SIZE_ - sizeof(size_)]{};
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,387 @@
+#pragma once
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace lockfreekit {
+
+enum class TracePhase : char {
+    instant = 'i',
+    begin = 'B',
+    end = 'E',
+    counter = 'C',
+};
+
+// One record of a snapshot or of a binary dump read back
+struct TraceEvent {
+    uint64_t timestamp_ns = 0;  // steady_clock
+    uint64_t arg = 0;
+    uint32_t thread = 0;  // Recorder thread id, see FlightRecorder
+    TracePhase phase = TracePhase::instant;
+    std::string name;
+};
+
+// Always-on in-process tracing. Every thread records into its own ring of RING_CAPACITY fixed-size records,
+// overwriting the oldest ones, so record() is wait-free: a few relaxed stores and no shared cache line. Event
+// names are pointers and must outlive the recorder (use literals).
+//
+// Rings are registered in a lock-free list the first time a thread records and are never freed; a thread that
+// exits hands its ring to the next new thread, which keeps its id. Any thread can snapshot() all rings while
+// they are being written: every record is guarded by its own sequence word, and records overwritten during the
+// snapshot are skipped rather than returned torn.
+//
+// Output is Chrome trace JSON (chrome://tracing, ui.perfetto.dev) or a compact binary dump that
+// install_crash_handler() also writes from a signal handler and read_binary() turns back into events. Needs
+// POSIX (write, sigaction).
+class FlightRecorder {
+   public:
+    static constexpr size_t RING_CAPACITY = 4096;
+
+    static void record(const char* name, TracePhase phase = TracePhase::instant, uint64_t arg = 0) noexcept {
+        Ring* ring = local_ring_;
+        if (ring == nullptr) {
+            ring = attach_thread();
+        }
+        ring->write(name, phase, arg, now_ns());
+    }
+
+    // The recorder id of the calling thread; ids are small integers in registration order
+    [[nodiscard]] static uint32_t thread_id() noexcept {
+        Ring* ring = local_ring_;
+        return ring != nullptr ? ring->thread : attach_thread()->thread;
+    }
+
+    // The records currently held by all rings, oldest first
+    [[nodiscard]] static std::vector<TraceEvent> snapshot() {
+        std::vector<TraceEvent> events;
+        for (Ring* ring = rings_.load(std::memory_order_acquire); ring != nullptr; ring = ring->next) {
+            ring->read([&](const Record& record) {
+                events.push_back(TraceEvent{record.timestamp_ns, record.arg, ring->thread, record.phase,
+                                            std::string(record.name != nullptr ? record.name : "")});
+            });
+        }
+        std::stable_sort(events.begin(), events.end(),
+                         [](const TraceEvent& a, const TraceEvent& b) { return a.timestamp_ns < b.timestamp_ns; });
+        return events;
+    }
+
+    static void write_chrome_json(std::ostream& out, const std::vector<TraceEvent>& events) {
+        out << "{\"traceEvents\":[";
+        char number[32];
+        for (size_t i = 0; i < events.size(); ++i) {
+            const TraceEvent& event = events[i];
+            // Chrome timestamps are microseconds
+            std::snprintf(number, sizeof(number), "%llu.%03llu",
+                          static_cast<unsigned long long>(event.timestamp_ns / 1000),
+                          static_cast<unsigned long long>(event.timestamp_ns % 1000));
+            out << (i == 0 ? "\n" : ",\n") << "{\"name\":\"";
+            write_json_string(out, event.name);
+            out << "\",\"ph\":\"" << static_cast<char>(event.phase) << "\",\"ts\":" << number
+                << ",\"pid\":1,\"tid\":" << event.thread;
+            if (event.phase == TracePhase::instant) {
+                out << ",\"s\":\"t\"";
+            }
+            out << ",\"args\":{\"" << (event.phase == TracePhase::counter ? "value" : "arg") << "\":" << event.arg
+                << "}}";
+        }
+        out << "\n]}\n";
+    }
+
+    // Snapshot of all rings as Chrome trace JSON
+    static void write_chrome_json(std::ostream& out) { write_chrome_json(out, snapshot()); }
+
+    // Dumps all rings to `fd` in the binary format. Async-signal-safe: no allocation, no locks, only write().
+    // Returns false if a write failed.
+    //
+    // Format, native byte order: the 8 bytes "LFKTRACE", a uint32 version and a uint32 reserved, then records
+    // until end of file: uint64 timestamp_ns, uint64 arg, uint32 thread, char phase, uint8 name length, name.
+    static bool write_binary(int fd) noexcept {
+        Writer writer{fd};
+        uint32_t header[2] = {BINARY_VERSION_, 0};
+        writer.put(BINARY_MAGIC_, sizeof(BINARY_MAGIC_) - 1);
+        writer.put(header, sizeof(header));
+        for (Ring* ring = rings_.load(std::memory_order_acquire); ring != nullptr; ring = ring->next) {
+            ring->read([&](const Record& record) {
+                const char* name = record.name != nullptr ? record.name : "";
+                const auto length = static_cast<uint8_t>(strnlen(name, UINT8_MAX));
+                writer.put(&record.timestamp_ns, sizeof(record.timestamp_ns));
+                writer.put(&record.arg, sizeof(record.arg));
+                writer.put(&ring->thread, sizeof(ring->thread));
+                writer.put(&record.phase, sizeof(record.phase));
+                writer.put(&length, sizeof(length));
+                writer.put(name, length);
+            });
+        }
+        return writer.flush();
+    }
+
+    // Parses a binary dump; throws std::runtime_error if `in` does not hold one. A record cut short at the end
+    // (the process died mid-dump) is dropped.
+    [[nodiscard]] static std::vector<TraceEvent> read_binary(std::istream& in) {
+        char magic[sizeof(BINARY_MAGIC_) - 1];
+        uint32_t header[2] = {};
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, BINARY_MAGIC_, sizeof(magic)) != 0 ||
+            !in.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != BINARY_VERSION_) {
+            throw std::runtime_error("Not a flight recorder dump");
+        }
+        std::vector<TraceEvent> events;
+        for (;;) {
+            TraceEvent event;
+            char phase = 0;
+            uint8_t length = 0;
+            if (!in.read(reinterpret_cast<char*>(&event.timestamp_ns), sizeof(event.timestamp_ns)) ||
+                !in.read(reinterpret_cast<char*>(&event.arg), sizeof(event.arg)) ||
+                !in.read(reinterpret_cast<char*>(&event.thread), sizeof(event.thread)) || !in.read(&phase, 1) ||
+                !in.read(reinterpret_cast<char*>(&length), 1)) {
+                break;
+            }
+            event.phase = static_cast<TracePhase>(phase);
+            event.name.resize(length);
+            if (!in.read(event.name.data(), length)) {
+                break;
+            }
+            events.push_back(std::move(event));
+        }
+        std::stable_sort(events.begin(), events.end(),
+                         [](const TraceEvent& a, const TraceEvent& b) { return a.timestamp_ns < b.timestamp_ns; });
+        return events;
+    }
+
+    // On SIGSEGV, SIGBUS, SIGFPE, SIGILL or SIGABRT, dumps all rings to `fd` with write_binary() and lets the
+    // signal's default action proceed. Open the file up front: nothing can be opened safely at crash time.
+    static void install_crash_handler(int fd) {
+        crash_fd_.store(fd, std::memory_order_relaxed);
+        struct sigaction action {};
+        action.sa_handler = &on_crash;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESETHAND | SA_NODEFER;
+        for (const int signal : {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT}) {
+            if (sigaction(signal, &action, nullptr) != 0) {
+                throw std::runtime_error("sigaction failed");
+            }
+        }
+    }
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static constexpr char BINARY_MAGIC_[] = "LFKTRACE";
+    static constexpr uint32_t BINARY_VERSION_ = 1;
+
+    static_assert((RING_CAPACITY & (RING_CAPACITY - 1)) == 0, "RING_CAPACITY must be a power of two");
+
+    struct Record {
+        uint64_t timestamp_ns;
+        const char* name;
+        uint64_t arg;
+        TracePhase phase;
+    };
+
+    // The fields are relaxed atomics so that a snapshot racing with the owner is not a data race; the sequence
+    // word tells it whether what it read belongs together.
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};  // 2 * pos + 2 once the record for `pos` is complete, odd while written
+        std::atomic<uint64_t> timestamp_ns{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> arg{0};
+        std::atomic<TracePhase> phase{TracePhase::instant};
+    };
+
+    struct Ring {
+        explicit Ring(uint32_t id) : thread(id) {}
+
+        // Owner only
+        void write(const char* name, TracePhase phase, uint64_t arg, uint64_t timestamp_ns) noexcept {
+            const uint64_t pos = head.load(std::memory_order_relaxed);
+            Slot& slot = slots[pos & (RING_CAPACITY - 1)];
+            slot.sequence.store(2 * pos + 1, std::memory_order_relaxed);
+            // Release fence: a reader that sees any of the new fields also sees the odd sequence
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.timestamp_ns.store(timestamp_ns, std::memory_order_relaxed);
+            slot.name.store(name, std::memory_order_relaxed);
+            slot.arg.store(arg, std::memory_order_relaxed);
+            slot.phase.store(phase, std::memory_order_relaxed);
+            slot.sequence.store(2 * pos + 2, std::memory_order_release);
+            head.store(pos + 1, std::memory_order_release);
+        }
+
+        // Any thread. Calls visit(record) for every complete record still in the ring, oldest first.
+        template <typename Visit>
+        void read(Visit&& visit) const noexcept(noexcept(visit(std::declval<const Record&>()))) {
+            const uint64_t end = head.load(std::memory_order_acquire);
+            for (uint64_t pos = end > RING_CAPACITY ? end - RING_CAPACITY : 0; pos < end; ++pos) {
+                const Slot& slot = slots[pos & (RING_CAPACITY - 1)];
+                const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+                if (sequence != 2 * pos + 2) {
+                    continue;  // Being overwritten, or already overwritten
+                }
+                const Record record{slot.timestamp_ns.load(std::memory_order_relaxed),
+                                    slot.name.load(std::memory_order_relaxed),
+                                    slot.arg.load(std::memory_order_relaxed),
+                                    slot.phase.load(std::memory_order_relaxed)};
+                // Acquire fence: the fields are read before the sequence is checked again
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+                    visit(record);
+                }
+            }
+        }
+
+        const uint32_t thread;
+        Ring* next = nullptr;                // Registry link, immutable once published
+        std::atomic<bool> attached{true};  // Owned by a live thread
+
+        alignas(CACHE_LINE_SIZE_) std::atomic<uint64_t> head{0};  // Records written so far
+        Slot slots[RING_CAPACITY];
+    };
+
+    // Gives the ring back when its thread exits
+    struct Lease {
+        Ring* ring = nullptr;
+        ~Lease() {
+            if (ring != nullptr) {
+                ring->attached.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    // Buffered write() for the signal-safe dump
+    struct Writer {
+        explicit Writer(int fd) noexcept : fd(fd) {}  // The buffer is left uninitialized, put() fills it
+
+        int fd;
+        size_t used = 0;
+        bool ok = true;
+        char buffer[4096];
+
+        void put(const void* data, size_t size) noexcept {
+            if (used + size > sizeof(buffer)) {
+                flush();
+            }
+            std::memcpy(buffer + used, data, size);
+            used += size;
+        }
+
+        bool flush() noexcept {
+            const char* data = buffer;
+            while (ok && used > 0) {
+                const ssize_t written = ::write(fd, data, used);
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (written <= 0) {
+                    ok = false;
+                    break;
+                }
+                data += written;
+                used -= static_cast<size_t>(written);
+            }
+            used = 0;
+            return ok;
+        }
+    };
+
+    static uint64_t now_ns() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    // Adopts the ring of an exited thread, or registers a new one
+    static Ring* attach_thread() {
+        static thread_local Lease lease;
+        Ring* ring = nullptr;
+        for (Ring* candidate = rings_.load(std::memory_order_acquire); candidate != nullptr;
+             candidate = candidate->next) {
+            bool attached = false;
+            if (!candidate->attached.load(std::memory_order_relaxed) &&
+                candidate->attached.compare_exchange_strong(attached, true, std::memory_order_acquire)) {
+                ring = candidate;
+                break;
+            }
+        }
+        if (ring == nullptr) {
+            ring = new Ring(next_thread_.fetch_add(1, std::memory_order_relaxed));
+            ring->next = rings_.load(std::memory_order_relaxed);
+            while (!rings_.compare_exchange_weak(ring->next, ring, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+            }
+        }
+        lease.ring = ring;
+        local_ring_ = ring;
+        return ring;
+    }
+
+    static void write_json_string(std::ostream& out, const std::string& text) {
+        for (const char c : text) {
+            if (c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                out << escaped;
+            } else {
+                out << c;
+            }
+        }
+    }
+
+    static void on_crash(int signal) {
+        const int saved_errno = errno;
+        const int fd = crash_fd_.load(std::memory_order_relaxed);
+        if (fd >= 0) {
+            (void)write_binary(fd);
+        }
+        errno = saved_errno;
+        raise(signal);  // SA_RESETHAND restored the default action
+    }
+
+    inline static std::atomic<Ring*> rings_{nullptr};
+    inline static std::atomic<uint32_t> next_thread_{0};
+    inline static std::atomic<int> crash_fd_{-1};
+    inline static thread_local Ring* local_ring_ = nullptr;
+};
+
+// Records a begin event now and the matching end event when it goes out of scope
+class TraceScope {
+   public:
+    explicit TraceScope(const char* name, uint64_t arg = 0) noexcept : name_(name) {
+        FlightRecorder::record(name_, TracePhase::begin, arg);
+    }
+
+    ~TraceScope() { FlightRecorder::record(name_, TracePhase::end); }
+
+    // Delete copy/move constructors and assignment operators
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+    TraceScope(TraceScope&&) = delete;
+    TraceScope& operator=(TraceScope&&) = delete;
+
+   private:
+    const char* const name_;
+};
+
+// MPMCQueue tracer that records the queue's events into the flight recorder, the position as argument:
+// MPMCQueue<T, 0, size_t, FlightRecorderQueueTracer>
+struct FlightRecorderQueueTracer {
+    void enqueued(uint64_t pos) noexcept { FlightRecorder::record("mpmc.enqueue", TracePhase::instant, pos); }
+    void dequeued(uint64_t pos) noexcept { FlightRecorder::record("mpmc.dequeue", TracePhase::instant, pos); }
+    void cas_retry(uint64_t pos) noexcept { FlightRecorder::record("mpmc.cas_retry", TracePhase::instant, pos); }
+    void full(uint64_t pos) noexcept { FlightRecorder::record("mpmc.full", TracePhase::instant, pos); }
+    void empty(uint64_t pos) noexcept { FlightRecorder::record("mpmc.empty", TracePhase::instant, pos); }
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <ctime>
+#else
+#include <algorithm>
+#include <thread>
+#endif
+
+namespace lockfreekit {
+
+// Raw futex on a std::atomic<uint32_t>, for waits that need a timeout (std::atomic::wait has none).
+//
+// Threads parked here must be woken with futex_wake(): std::atomic::notify_*() only issues the wake-up for
+// waiters the standard library registered itself. Waits may return spuriously; callers re-check their condition.
+// Elsewhere than Linux the waits degrade to short sleeps.
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit integer");
+
+// Sleeps while `word` == `expected`, at most `timeout`
+inline void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::nanoseconds timeout) noexcept {
+    if (timeout.count() <= 0) {
+        return;
+    }
+#if defined(__linux__)
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    timespec relative{};
+    relative.tv_sec = static_cast<time_t>(seconds.count());
+    relative.tv_nsec = static_cast<long>((timeout - seconds).count());
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, &relative, nullptr, 0);
+#else
+    if (word.load(std::memory_order_relaxed) == expected) {
+        std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(timeout, std::chrono::milliseconds(1)));
+    }
+#endif
+}
+
+// Sleeps while `word` == `expected`, without a timeout
+inline void futex_wait(std::atomic<uint32_t>& word, uint32_t expected) noexcept {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+    futex_wait(word, expected, std::chrono::milliseconds(1));
+#endif
+}
+
+// Wakes up to `count` threads parked on `word`
+inline void futex_wake(std::atomic<uint32_t>& word, int count = INT_MAX) noexcept {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+    (void)word;
+    (void)count;
+#endif
+}
+
+}  // namespace lockfreekit
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+
+namespace lockfreekit {
+
+// Link field to embed in (derive from) anything pushed through an IntrusiveMPSCQueue. A node may sit in at
+// most one queue at a time.
+struct IntrusiveMPSCNode {
+    IntrusiveMPSCNode() noexcept = default;
+    // Copies of a message start out unlinked; queue membership is not part of the value
+    IntrusiveMPSCNode(const IntrusiveMPSCNode&) noexcept {}
+    IntrusiveMPSCNode& operator=(const IntrusiveMPSCNode&) noexcept { return *this; }
+
+    std::atomic<IntrusiveMPSCNode*> mpsc_next{nullptr};
+};
+
+// Unbounded intrusive MPSC queue after Dmitry Vyukov, with a stub node.
+//
+// push() is a single XCHG on head_ and never allocates: the caller's object is the node. pop() is wait-free and
+// must only be called by one consumer thread at a time. The queue never owns or frees the nodes.
+template <typename T>
+requires std::derived_from<T, IntrusiveMPSCNode>
+class IntrusiveMPSCQueue {
+   public:
+    IntrusiveMPSCQueue() noexcept : head_(&stub_), tail_(&stub_) {}
+
+    // Returns true if the queue was empty, i.e. the consumer had taken everything pushed before. Schedulers use
+    // this "mailbox became non-empty" edge to decide who wakes up or enqueues the consumer.
+    bool push(T* value) noexcept { return push_node(value) == &stub_; }
+
+    // Returns nullptr if the queue is empty, or if a producer is between its XCHG and linking its node (the
+    // element becomes visible as soon as that producer's next instruction runs).
+    [[nodiscard]] T* pop() noexcept {
+        IntrusiveMPSCNode* tail = tail_.load(std::memory_order_relaxed);
+        IntrusiveMPSCNode* next = tail->mpsc_next.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (next == nullptr) {
+                return nullptr;  // Empty
+            }
+            // Skip the stub
+            tail_.store(next, std::memory_order_relaxed);
+            tail = next;
+            next = next->mpsc_next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail_.store(next, std::memory_order_relaxed);
+            return static_cast<T*>(tail);
+        }
+        if (tail != head_.load(std::memory_order_acquire)) {
+            return nullptr;  // A producer swapped head_ but has not linked its node yet
+        }
+        // `tail` is the last node; re-insert the stub behind it so that `tail` can be handed out
+        push_node(&stub_);
+        next = tail->mpsc_next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail_.store(next, std::memory_order_relaxed);
+            return static_cast<T*>(tail);
+        }
+        return nullptr;
+    }
+
+    // Consumer-side check; producers may add elements at any time. Unlike a failed pop() this also counts
+    // elements whose producer has not linked them yet. Its seq_cst load of head_ against the producers' seq_cst
+    // XCHG is what lets a consumer publish "going idle" and then re-check without missing a push.
+    [[nodiscard]] bool empty() const noexcept {
+        return tail_.load(std::memory_order_relaxed) == &stub_ && head_.load(std::memory_order_seq_cst) == &stub_;
+    }
+
+    // Delete copy/move constructors and assignment operators
+    IntrusiveMPSCQueue(const IntrusiveMPSCQueue&) = delete;
+    IntrusiveMPSCQueue& operator=(const IntrusiveMPSCQueue&) = delete;
+    IntrusiveMPSCQueue(IntrusiveMPSCQueue&&) = delete;
+    IntrusiveMPSCQueue& operator=(IntrusiveMPSCQueue&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+
+    IntrusiveMPSCNode* push_node(IntrusiveMPSCNode* node) noexcept {
+        node->mpsc_next.store(nullptr, std::memory_order_relaxed);
+        // Release publishes the node's payload, acquire lets us write into the previous node; seq_cst pairs
+        // with empty() (free on x86, where XCHG is a full barrier anyway)
+        IntrusiveMPSCNode* prev = head_.exchange(node, std::memory_order_seq_cst);
+        prev->mpsc_next.store(node, std::memory_order_release);
+        return prev;
+    }
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<IntrusiveMPSCNode*> head_;  // Producers' end
+    // Consumer's end. Atomic only so that a scheduler may peek at it from outside the consumer (see empty()).
+    alignas(CACHE_LINE_SIZE_) std::atomic<IntrusiveMPSCNode*> tail_;
+    IntrusiveMPSCNode stub_;
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <thread>
+
+#include "mpmc_queue.hpp"
+
+namespace lockfreekit {
+
+// Handle to a MessagePool buffer. Four trivially copyable bytes, so MPMCQueue<MessageRef> uses packed slots.
+struct MessageRef {
+    uint32_t index = 0;
+
+    friend bool operator==(MessageRef, MessageRef) = default;
+};
+
+// Pool of fixed-size message buffers shared by reference count, for delivering one payload to many consumer
+// queues without copying it.
+//
+// The count is deferred: while the producer fills a buffer it is the only holder and nobody counts. share()
+// then hands out all K references with one plain store, so a K-way multicast costs K decrements (one per
+// consumer, when it is done) and no increments, where K copies of a shared_ptr cost K increments on the same
+// contended line as well. The consumer whose release() drops the count to zero puts the buffer back on the
+// pool's free ring.
+class MessagePool {
+   public:
+    MessagePool(size_t buffers, size_t buffer_bytes)
+        : buffers_(buffers),
+          buffer_bytes_(buffer_bytes),
+          stride_((sizeof(Header) + buffer_bytes + CACHE_LINE_SIZE_ - 1) / CACHE_LINE_SIZE_ * CACHE_LINE_SIZE_),
+          free_(buffers) {
+        if (buffers_ > UINT32_MAX) {
+            throw std::invalid_argument("MessagePool holds at most 2^32 - 1 buffers");
+        }
+        storage_.reset(
+            static_cast<std::byte*>(::operator new(stride_ * buffers_, std::align_val_t{CACHE_LINE_SIZE_})));
+        for (size_t i = 0; i < buffers_; ++i) {
+            ::new (storage_.get() + i * stride_) Header;
+            (void)free_.enqueue(static_cast<uint32_t>(i));
+        }
+    }
+
+    // Any thread. A buffer only the caller holds, or nullopt if the pool is exhausted.
+    [[nodiscard]] std::optional<MessageRef> acquire() {
+        const std::optional<uint32_t> index = free_.dequeue();
+        if (!index) {
+            return std::nullopt;
+        }
+        header(MessageRef{*index}).size = 0;
+        return MessageRef{*index};
+    }
+
+    [[nodiscard]] std::byte* data(MessageRef ref) noexcept { return reinterpret_cast<std::byte*>(&header(ref) + 1); }
+    [[nodiscard]] const std::byte* data(MessageRef ref) const noexcept {
+        return reinterpret_cast<const std::byte*>(&header(ref) + 1);
+    }
+
+    // Bytes in use, set by the producer before share()
+    [[nodiscard]] size_t size(MessageRef ref) const noexcept { return header(ref).size; }
+    void set_size(MessageRef ref, size_t size) noexcept { header(ref).size = static_cast<uint32_t>(size); }
+
+    // Sole holder only (after acquire). Replaces the caller's reference by `holders` references, e.g. one per
+    // consumer queue plus one if the producer keeps reading it. Zero releases the buffer right away.
+    void share(MessageRef ref, uint32_t holders) {
+        if (holders == 0) {
+            (void)free_.enqueue(ref.index);
+            return;
+        }
+        // Release: the payload is published with the count (queues publish it as well, this covers holders
+        // that get the handle some other way)
+        header(ref).references.store(holders, std::memory_order_release);
+    }
+
+    // Holder only. Adds `count` references to a shared buffer.
+    void retain(MessageRef ref, uint32_t count = 1) noexcept {
+        header(ref).references.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // Holder only. Drops one reference; the last one returns the buffer to the pool.
+    void release(MessageRef ref) {
+        // Acq_rel: every holder's reads happen before the buffer is handed out again
+        if (header(ref).references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            (void)free_.enqueue(ref.index);  // Never full: it has a slot per buffer
+        }
+    }
+
+    // Sole holder only. Shares the buffer with every queue and enqueues it into each, spinning on full queues
+    // if `wait`, else skipping them. Returns the number of queues it was delivered to; the references of skipped
+    // queues are dropped, so the buffer returns to the pool if it reached none.
+    template <typename Queue>
+    size_t multicast(MessageRef ref, std::span<Queue* const> queues, bool wait = true) {
+        if (queues.empty()) {
+            share(ref, 0);
+            return 0;
+        }
+        share(ref, static_cast<uint32_t>(queues.size()));
+        size_t delivered = 0;
+        for (Queue* queue : queues) {
+            bool sent = queue->enqueue(ref);
+            while (!sent && wait) {
+                std::this_thread::yield();
+                sent = queue->enqueue(ref);
+            }
+            if (sent) {
+                ++delivered;
+            } else {
+                release(ref);
+            }
+        }
+        return delivered;
+    }
+
+    // Buffers on the free ring right now
+    [[nodiscard]] size_t available() const noexcept { return free_.approx_size(); }
+
+    [[nodiscard]] size_t capacity() const noexcept { return buffers_; }
+    [[nodiscard]] size_t buffer_bytes() const noexcept { return buffer_bytes_; }
+
+    // Delete copy/move constructors and assignment operators
+    MessagePool(const MessagePool&) = delete;
+    MessagePool& operator=(const MessagePool&) = delete;
+    MessagePool(MessagePool&&) = delete;
+    MessagePool& operator=(MessagePool&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+
+    // Sits right before the payload; buffers start on cache line boundaries
+    struct alignas(16) Header {
+        std::atomic<uint32_t> references{0};
+        uint32_t size = 0;
+    };
+
+    struct AlignedDelete {
+        void operator()(std::byte* memory) const noexcept {
+            ::operator delete(memory, std::align_val_t{CACHE_LINE_SIZE_});
+        }
+    };
+
+    Header& header(MessageRef ref) noexcept {
+        return *std::launder(reinterpret_cast<Header*>(storage_.get() + ref.index * stride_));
+    }
+    const Header& header(MessageRef ref) const noexcept { return const_cast<MessagePool*>(this)->header(ref); }
+
+    const size_t buffers_;
+    const size_t buffer_bytes_;
+    const size_t stride_;
+    std::unique_ptr<std::byte, AlignedDelete> storage_;
+    MPMCQueue<uint32_t> free_;
+};
+
+}  // namespace lockfreekit
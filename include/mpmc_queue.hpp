@@ -1,10 +1,15 @@
+#pragma once
+
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <vector>
 #include <array>
 #include <optional>
 #include <stdexcept>
 #include <concepts>
+#include <limits>
 #include <type_traits>
 
 namespace lockfreekit {
@@ -12,8 +17,37 @@ namespace lockfreekit {
 template <typename T>
 concept QueueValue = std::default_initializable<T> &&(std::movable<T> || std::copyable<T>);
 
-template <typename T, size_t static_capacity = 0>
-requires QueueValue<T>
+// Values small enough to share one 64-bit slot word with a 32-bit sequence
+template <typename T>
+concept PackableValue = std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(uint32_t);
+
+// Type of head_, tail_ and the slot sequences. Indices narrower than size_t wrap around during the queue's
+// lifetime, see MAX_CAPACITY_.
+template <typename Index>
+concept QueueIndex = std::unsigned_integral<Index> && !std::same_as<Index, bool> && sizeof(Index) >= sizeof(uint16_t) &&
+                     sizeof(Index) <= sizeof(size_t);
+
+// Tracing hook of MPMCQueue. The queue calls these on its hot paths with the position involved; the default
+// does nothing and compiles away. See FlightRecorderQueueTracer in flight_recorder.hpp.
+struct NoQueueTracer {
+    void enqueued(uint64_t /*pos*/) noexcept {}
+    void dequeued(uint64_t /*pos*/) noexcept {}
+    void cas_retry(uint64_t /*pos*/) noexcept {}  // Lost a race for a position and tries the next one
+    void full(uint64_t /*pos*/) noexcept {}
+    void empty(uint64_t /*pos*/) noexcept {}
+};
+
+template <typename Tracer>
+concept QueueTracer = std::default_initializable<Tracer> && requires(Tracer tracer, uint64_t pos) {
+    tracer.enqueued(pos);
+    tracer.dequeued(pos);
+    tracer.cas_retry(pos);
+    tracer.full(pos);
+    tracer.empty(pos);
+};
+
+template <typename T, size_t static_capacity = 0, typename Index = size_t, typename Tracer = NoQueueTracer>
+requires QueueValue<T> && QueueIndex<Index> && QueueTracer<Tracer>
 class MPMCQueue {
    public:
     // Dynamic-capacity constructor
@@ -22,72 +56,106 @@ class MPMCQueue {
         if (capacity_ < 1) {
             throw std::invalid_argument("Queue capacity must be > 0");
         }
+        if (capacity_ > MAX_CAPACITY_) {
+            throw std::invalid_argument("Queue capacity too large for the index type");
+        }
+        if (NARROW_INDEX_ && (capacity_ & (capacity_ - 1)) != 0) {
+            throw std::invalid_argument("Queue capacity must be a power of two for narrow index types");
+        }
         for (size_t i = 0; i < capacity_; ++i) {
-            dynamic_buffer_[i].sequence.store(i, std::memory_order_relaxed);
+            reset_slot(dynamic_buffer_[i], static_cast<Index>(i));
         }
     }
 
     // Static-capacity consetxpr constructor
     constexpr MPMCQueue() requires(static_capacity > 0) {
         for (size_t i = 0; i < static_capacity; ++i) {
-            static_buffer_[i].sequence.store(i, std::memory_order_relaxed);
+            reset_slot(static_buffer_[i], static_cast<Index>(i));
         }
     }
 
     [[nodiscard]] bool enqueue(const T& value) {
-        size_t pos = tail_.load(std::memory_order_relaxed);
+        if constexpr (PACKED_) {
+            return enqueue_packed(value);
+        } else {
+            Index pos = tail_.load(std::memory_order_relaxed);
 
-        for (;;) {
-            Slot& slot = buffer_at(pos);
-            // Acquire ensures that if the slot's sequence indicates it is free (diff == 0),
-            // then any writes by the previous consumer (like resetting the slot's state and
-            // moving out its value) — which happened before its release-store — are now
-            // visible to us. This guarantees we won't write into a slot before the consumer
-            // has fully finished with it.
-            const size_t seq = slot.sequence.load(std::memory_order_acquire);
-            const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            for (;;) {
+                Slot& slot = buffer_at(pos);
+                // Acquire ensures that if the slot's sequence indicates it is free (diff == 0),
+                // then any writes by the previous consumer (like resetting the slot's state and
+                // moving out its value) — which happened before its release-store — are now
+                // visible to us. This guarantees we won't write into a slot before the consumer
+                // has fully finished with it.
+                const Index seq = slot.sequence.load(std::memory_order_acquire);
+                const SignedIndex diff = distance(seq, pos);
 
-            if (diff == 0) {
-                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
-                    slot.value = value;
-                    slot.sequence.store(pos + 1, std::memory_order_release);
-                    return true;
+                if (diff == 0) {
+                    if (tail_.compare_exchange_weak(pos, static_cast<Index>(pos + 1), std::memory_order_relaxed)) {
+                        slot.value = value;
+                        slot.sequence.store(static_cast<Index>(pos + 1), std::memory_order_release);
+                        tracer_.enqueued(pos);
+                        return true;
+                    }
+                    tracer_.cas_retry(pos);
+                } else if (diff < 0) {
+                    tracer_.full(pos);
+                    return false;  // Full
+                } else {
+                    pos = tail_.load(std::memory_order_relaxed);
                 }
-            } else if (diff < 0) {
-                return false;  // Full
-            } else {
-                pos = tail_.load(std::memory_order_relaxed);
             }
         }
     }
 
     [[nodiscard]] std::optional<T> dequeue() {
-        size_t pos = head_.load(std::memory_order_relaxed);
+        if constexpr (PACKED_) {
+            return dequeue_packed();
+        } else {
+            Index pos = head_.load(std::memory_order_relaxed);
 
-        for (;;) {
-            Slot& slot = buffer_at(pos);
-            // Acquire ensures that if `seq` shows the slot is ready (diff == 0),
-            // then any writes to slot.value by the producer (done before its release-store)
-            // are visible here, so we can safely read/move the value.
-            const size_t seq = slot.sequence.load(std::memory_order_acquire);
-            const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            for (;;) {
+                Slot& slot = buffer_at(pos);
+                // Acquire ensures that if `seq` shows the slot is ready (diff == 0),
+                // then any writes to slot.value by the producer (done before its release-store)
+                // are visible here, so we can safely read/move the value.
+                const Index seq = slot.sequence.load(std::memory_order_acquire);
+                const SignedIndex diff = distance(seq, static_cast<Index>(pos + 1));
 
-            if (diff == 0) {
-                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
-                    T value = std::move(slot.value);
-                    slot.sequence.store(pos + capacity(), std::memory_order_release);
-                    return value;
+                if (diff == 0) {
+                    if (head_.compare_exchange_weak(pos, static_cast<Index>(pos + 1), std::memory_order_relaxed)) {
+                        T value = std::move(slot.value);
+                        slot.sequence.store(static_cast<Index>(pos + capacity()), std::memory_order_release);
+                        tracer_.dequeued(pos);
+                        return value;
+                    }
+                    tracer_.cas_retry(pos);
+                } else if (diff < 0) {
+                    tracer_.empty(pos);
+                    return std::nullopt;  // Empty
+                } else {
+                    pos = head_.load(std::memory_order_relaxed);
                 }
-            } else if (diff < 0) {
-                return std::nullopt;  // Empty
-            } else {
-                pos = head_.load(std::memory_order_relaxed);
             }
         }
     }
 
+    // True if a dequeue() at this moment would report the queue empty
+    [[nodiscard]] bool empty() const noexcept {
+        const Index pos = head_.load(std::memory_order_relaxed);
+        if constexpr (PACKED_) {
+            return packed_diff(buffer_at(pos).word.load(std::memory_order_acquire), pos, true) < 0;
+        } else {
+            return distance(buffer_at(pos).sequence.load(std::memory_order_acquire), static_cast<Index>(pos + 1)) < 0;
+        }
+    }
+
     [[nodiscard]] size_t approx_size() const noexcept {
-        return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_relaxed);
+        // The two loads are not a snapshot, head_ may have moved past the tail_ we read
+        const Index tail = tail_.load(std::memory_order_relaxed);
+        const Index head = head_.load(std::memory_order_relaxed);
+        const SignedIndex size = distance(tail, head);
+        return size > 0 ? static_cast<size_t>(size) : 0;
     }
 
     [[nodiscard]] constexpr size_t capacity() const noexcept {
@@ -98,11 +166,14 @@ class MPMCQueue {
         }
     }
 
+    // The queue's tracer, for tracers that keep state
+    [[nodiscard]] Tracer& tracer() noexcept { return tracer_; }
+
     void thread_unsafe_clear() noexcept {
         head_.store(0, std::memory_order_relaxed);
         tail_.store(0, std::memory_order_relaxed);
         for (size_t i = 0; i < capacity(); ++i) {
-            buffer_at(i).sequence.store(i, std::memory_order_relaxed);
+            reset_slot(buffer_at(static_cast<Index>(i)), static_cast<Index>(i));
         }
     }
 
@@ -113,12 +184,130 @@ class MPMCQueue {
     MPMCQueue& operator=(MPMCQueue&&) = delete;
 
    private:
-    struct Slot {
-        std::atomic<size_t> sequence;
+    using SignedIndex = std::make_signed_t<Index>;
+
+    static constexpr bool PACKED_ = PackableValue<T>;
+    static constexpr bool NARROW_INDEX_ = sizeof(Index) < sizeof(size_t);
+    static constexpr int INDEX_BITS_ = std::numeric_limits<Index>::digits;
+
+    // Positions are compared by their wrapped difference, which is only meaningful while it stays well inside
+    // the signed range. A narrow index also wraps for real, so the capacity has to divide 2^INDEX_BITS_.
+    static constexpr size_t MAX_CAPACITY_ = NARROW_INDEX_ ? size_t{1} << (INDEX_BITS_ - 2)
+                                            : PACKED_     ? size_t{1} << 30
+                                                          : std::numeric_limits<size_t>::max();
+
+    static_assert(static_capacity <= MAX_CAPACITY_, "Queue capacity too large for the index type");
+    static_assert(!NARROW_INDEX_ || (static_capacity & (static_capacity - 1)) == 0,
+                  "Queue capacity must be a power of two for narrow index types");
+
+    // Wrap-safe `a - b`
+    static constexpr SignedIndex distance(Index a, Index b) noexcept { return static_cast<SignedIndex>(a - b); }
+
+    struct UnpackedSlot {
+        std::atomic<Index> sequence;
         T value;
     };
 
-    Slot& buffer_at(size_t pos) noexcept {
+    // High 32 bits: sequence, low 32 bits: value. The sequence counts in half-steps, 2 * pos while the slot
+    // is free for the enqueue at `pos` and 2 * pos + 1 once it holds that element, so "filled" and "consumed"
+    // never look alike even for capacity 1.
+    struct PackedSlot {
+        std::atomic<uint64_t> word;
+    };
+
+    using Slot = std::conditional_t<PACKED_, PackedSlot, UnpackedSlot>;
+
+    // Width of the packed sequence: one more bit than the index (for the half-step), at most 32
+    static constexpr int PACKED_SEQUENCE_BITS_ = INDEX_BITS_ + 1 < 32 ? INDEX_BITS_ + 1 : 32;
+
+    static constexpr uint64_t pack(Index pos, bool full, uint32_t bits) noexcept {
+        const auto sequence = static_cast<uint32_t>(2 * static_cast<uint64_t>(pos) + (full ? 1 : 0));
+        return (static_cast<uint64_t>(sequence) << 32) | bits;
+    }
+
+    // Wrap-safe distance between a slot's sequence and the one expected for `pos`, sign-extended from
+    // PACKED_SEQUENCE_BITS_ so that narrow indices wrap at the same point as the sequence
+    static constexpr int32_t packed_diff(uint64_t word, Index pos, bool full) noexcept {
+        constexpr int shift = 32 - PACKED_SEQUENCE_BITS_;
+        const uint32_t diff = static_cast<uint32_t>(word >> 32) - static_cast<uint32_t>(pack(pos, full, 0) >> 32);
+        return static_cast<int32_t>(diff << shift) >> shift;
+    }
+
+    // Moves `index` from `pos` to `pos + 1` unless another thread already did; returns the index afterwards.
+    static Index advance(std::atomic<Index>& index, Index pos) noexcept {
+        const auto next = static_cast<Index>(pos + 1);
+        return index.compare_exchange_strong(pos, next, std::memory_order_relaxed) ? next : pos;
+    }
+
+    static void reset_slot(Slot& slot, Index pos) noexcept {
+        if constexpr (PACKED_) {
+            slot.word.store(pack(pos, false, 0), std::memory_order_relaxed);
+        } else {
+            slot.sequence.store(pos, std::memory_order_relaxed);
+        }
+    }
+
+    // A packed slot is claimed and published by the same CAS, so tail_ is only a hint that can lag one step
+    // behind; whoever finds the slot at tail_ already filled moves tail_ along.
+    bool enqueue_packed(const T& value) {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(T));
+        Index pos = tail_.load(std::memory_order_relaxed);
+
+        for (;;) {
+            Slot& slot = buffer_at(pos);
+            uint64_t word = slot.word.load(std::memory_order_acquire);
+            const int32_t diff = packed_diff(word, pos, false);
+
+            if (diff == 0) {
+                // Release publishes whatever the producer wrote before handing us `value`
+                if (slot.word.compare_exchange_weak(word, pack(pos, true, bits), std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+                    advance(tail_, pos);
+                    tracer_.enqueued(pos);
+                    return true;
+                }
+                tracer_.cas_retry(pos);
+            } else if (diff < 0) {
+                tracer_.full(pos);
+                return false;  // Full
+            } else {
+                pos = advance(tail_, pos);
+            }
+        }
+    }
+
+    std::optional<T> dequeue_packed() {
+        Index pos = head_.load(std::memory_order_relaxed);
+
+        for (;;) {
+            Slot& slot = buffer_at(pos);
+            uint64_t word = slot.word.load(std::memory_order_relaxed);
+            const int32_t diff = packed_diff(word, pos, true);
+
+            if (diff == 0) {
+                // Acquire pairs with the producer's release CAS on the same word
+                const uint64_t emptied = pack(static_cast<Index>(pos + capacity()), false, 0);
+                if (slot.word.compare_exchange_weak(word, emptied, std::memory_order_acquire,
+                                                    std::memory_order_relaxed)) {
+                    advance(head_, pos);
+                    tracer_.dequeued(pos);
+                    T value;
+                    const auto bits = static_cast<uint32_t>(word);
+                    std::memcpy(static_cast<void*>(&value), &bits, sizeof(T));  // T may have member initializers
+                    return value;
+                }
+                tracer_.cas_retry(pos);
+            } else if (diff < 0) {
+                tracer_.empty(pos);
+                return std::nullopt;  // Empty
+            } else {
+                pos = advance(head_, pos);
+            }
+        }
+    }
+
+    Slot& buffer_at(Index pos) noexcept {
         if constexpr (static_capacity > 0) {
             // Optimize for power-of-two capacity with bitmask
             if constexpr ((static_capacity & (static_capacity - 1)) == 0) {
@@ -126,21 +315,26 @@ class MPMCQueue {
             } else {
                 return static_buffer_[pos % static_capacity];
             }
+        } else if constexpr (NARROW_INDEX_) {
+            return dynamic_buffer_[pos & (capacity_ - 1)];
         } else {
             return dynamic_buffer_[pos % capacity_];
         }
     }
 
+    const Slot& buffer_at(Index pos) const noexcept { return const_cast<MPMCQueue*>(this)->buffer_at(pos); }
+
     static constexpr size_t CACHE_LINE_SIZE_ = 64;
 
     [[no_unique_address]] std::conditional_t<(static_capacity > 0), std::array<Slot, static_capacity>, char>
         static_buffer_{};
     std::vector<Slot> dynamic_buffer_;         // Only used if static_capacity == 0
     const size_t capacity_ = static_capacity;  // Only meaningful for dynamic case
+    [[no_unique_address]] Tracer tracer_{};
 
-    alignas(CACHE_LINE_SIZE_) std::atomic<size_t> head_{};
+    alignas(CACHE_LINE_SIZE_) std::atomic<Index> head_{};
     char pad0[CACHE_LINE_SIZE_ - sizeof(head_)]{};
-    alignas(CACHE_LINE_SIZE_) std::atomic<size_t> tail_{};
+    alignas(CACHE_LINE_SIZE_) std::atomic<Index> tail_{};
     char pad1[CACHE_LINE_SIZE_ - sizeof(tail_)]{};
 };
 
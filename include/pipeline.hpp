@@ -0,0 +1,476 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "mpmc_queue.hpp"
+#include "spin_wait.hpp"
+#include "spsc_queue.hpp"
+
+namespace lockfreekit {
+
+// How a stage waits for input
+enum class WaitMode {
+    busy_poll,  // Never blocks: spins, and yields only so that an oversubscribed machine keeps making progress
+    park,       // Spins briefly, then sleeps in std::atomic::wait until a producer pushes and notifies
+};
+
+struct StageOptions {
+    size_t parallelism = 1;  // Threads running the stage; items of the input queue are shared between them
+    int cpu = -1;            // Pin replica i to core cpu + i; -1 leaves placement to the OS
+    WaitMode wait = WaitMode::busy_poll;
+    size_t queue_capacity = 1024;  // Capacity of the stage's input queue
+};
+
+// Snapshot of one stage, see Pipeline::stats()
+struct StageStats {
+    std::string name;
+    size_t parallelism = 0;
+    uint64_t items_in = 0;   // Items taken from the input queue (0 for sources)
+    uint64_t items_out = 0;  // Items emitted downstream (0 for sinks)
+    double seconds = 0;      // Since start(), or until the stage finished
+    size_t queue_depth = 0;  // Approximate number of items waiting in the input queue
+    size_t queue_capacity = 0;
+    const char* queue_kind = "none";  // "spsc" or "mpmc"
+};
+
+// Bounded queue on one pipeline edge. An edge with one producer and one consumer thread is an SPSCQueue, any
+// other cardinality an MPMCQueue. Finishes (pop() returns nullopt) once every producer closed it and it drained.
+template <typename T>
+requires QueueValue<T>
+class PipelineChannel {
+   public:
+    PipelineChannel(size_t capacity, size_t producers, size_t consumers, WaitMode wait)
+        : open_producers_(producers), parking_(wait == WaitMode::park) {
+        if (producers == 1 && consumers == 1) {
+            spsc_ = std::make_unique<SPSCQueue<T>>(capacity);
+        } else {
+            mpmc_ = std::make_unique<MPMCQueue<T>>(capacity);
+        }
+    }
+
+    // Waits (spinning, then yielding) while the queue is full: backpressure on the producing stage
+    void push(const T& value) {
+        for (SpinWait spin; !(spsc_ ? spsc_->enqueue(value) : mpmc_->enqueue(value));) {
+            spin.wait();
+        }
+        if (parking_) {
+            // Pairs with the fence in pop(): either we see the sleeper, or it sees the value we just pushed
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_relaxed) > 0) {
+                epoch_.fetch_add(1, std::memory_order_release);
+                epoch_.notify_one();
+            }
+        }
+    }
+
+    // Returns nullopt once all producers are done and the queue is drained
+    [[nodiscard]] std::optional<T> pop() {
+        SpinWait spin;
+        uint32_t idle = 0;
+        for (;;) {
+            if (auto value = try_pop()) {
+                return value;
+            }
+            if (open_producers_.load(std::memory_order_acquire) == 0) {
+                return try_pop();  // Everything pushed before the last close() is visible now
+            }
+            if (!parking_ || ++idle < IDLE_SPINS_) {
+                spin.wait();
+                continue;
+            }
+            idle = 0;
+            const uint32_t epoch = epoch_.load(std::memory_order_acquire);
+            sleepers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (empty() && open_producers_.load(std::memory_order_acquire) > 0) {
+                epoch_.wait(epoch, std::memory_order_acquire);
+            }
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Called once by every producer thread when it will not push anymore
+    void close() {
+        if (open_producers_.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+            epoch_.fetch_add(1, std::memory_order_release);
+            epoch_.notify_all();
+        }
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return spsc_ ? spsc_->empty() : mpmc_->empty(); }
+
+    [[nodiscard]] size_t approx_size() const noexcept { return spsc_ ? spsc_->approx_size() : mpmc_->approx_size(); }
+
+    [[nodiscard]] size_t capacity() const noexcept { return spsc_ ? spsc_->capacity() : mpmc_->capacity(); }
+
+    [[nodiscard]] const char* kind() const noexcept { return spsc_ ? "spsc" : "mpmc"; }
+
+    // Delete copy/move constructors and assignment operators
+    PipelineChannel(const PipelineChannel&) = delete;
+    PipelineChannel& operator=(const PipelineChannel&) = delete;
+    PipelineChannel(PipelineChannel&&) = delete;
+    PipelineChannel& operator=(PipelineChannel&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    // Empty polls before a parking consumer goes to sleep
+    static constexpr uint32_t IDLE_SPINS_ = 256;
+
+    std::optional<T> try_pop() { return spsc_ ? spsc_->dequeue() : mpmc_->dequeue(); }
+
+    std::unique_ptr<SPSCQueue<T>> spsc_;
+    std::unique_ptr<MPMCQueue<T>> mpmc_;
+    std::atomic<size_t> open_producers_;
+    const bool parking_;
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<uint32_t> sleepers_{0};
+    std::atomic<uint32_t> epoch_{0};
+    char pad0[CACHE_LINE_SIZE_ - sizeof(sleepers_) - sizeof(epoch_)]{};
+};
+
+// Pushes a stage's results into the next stage's input queue
+template <typename T>
+class Emitter {
+   public:
+    void operator()(const T& value) {
+        channel_.push(value);
+        out_.store(out_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+   private:
+    template <typename In, typename Out, typename F>
+    friend class StageImpl;
+
+    Emitter(PipelineChannel<T>& channel, std::atomic<uint64_t>& out) noexcept : channel_(channel), out_(out) {}
+
+    PipelineChannel<T>& channel_;
+    std::atomic<uint64_t>& out_;
+};
+
+// Input side of a stage; nothing for sources
+template <typename T>
+struct StageInput {
+    std::unique_ptr<PipelineChannel<T>> channel;
+    size_t producers = 0;  // Upstream threads, known once the graph is connected
+};
+
+template <>
+struct StageInput<void> {};
+
+class Pipeline;
+
+// Type-erased part of a stage, see Stage<In, Out>
+class PipelineStage {
+   public:
+    virtual ~PipelineStage() = default;
+
+    [[nodiscard]] const std::string& name() const noexcept { return name_; }
+
+    [[nodiscard]] const StageOptions& options() const noexcept { return options_; }
+
+    // Delete copy/move constructors and assignment operators
+    PipelineStage(const PipelineStage&) = delete;
+    PipelineStage& operator=(const PipelineStage&) = delete;
+    PipelineStage(PipelineStage&&) = delete;
+    PipelineStage& operator=(PipelineStage&&) = delete;
+
+   protected:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+
+    // Written by a single replica each, read by stats()
+    struct alignas(CACHE_LINE_SIZE_) Counters {
+        std::atomic<uint64_t> in{0};
+        std::atomic<uint64_t> out{0};
+    };
+
+    PipelineStage(std::string name, const StageOptions& options) : name_(std::move(name)), options_(options) {
+        if (options_.parallelism < 1) {
+            throw std::invalid_argument("Stage parallelism must be > 0");
+        }
+        if (options_.queue_capacity < 1) {
+            throw std::invalid_argument("Stage queue capacity must be > 0");
+        }
+        counters_ = std::make_unique<Counters[]>(options_.parallelism);
+    }
+
+    Counters& counters(size_t replica) noexcept { return counters_[replica]; }
+
+   private:
+    friend class Pipeline;
+
+    // Body of replica `replica`; returns when the input is finished (or, for sources, on stop)
+    virtual void run(size_t replica, const std::atomic<bool>& stopping) = 0;
+    // Checks the wiring and creates the input queue
+    virtual void open() = 0;
+    // Called by each replica when it is done, so that the next stage can finish
+    virtual void close_output() = 0;
+    virtual void input_stats(StageStats& stats) const = 0;
+
+    const std::string name_;
+    const StageOptions options_;
+    std::unique_ptr<Counters[]> counters_;
+    std::atomic<size_t> running_{0};
+    std::atomic<int64_t> finished_at_{0};  // steady_clock nanoseconds, 0 while running
+};
+
+// A stage consuming `In` and producing `Out`; `In` is void for sources and `Out` is void for sinks.
+template <typename In, typename Out>
+requires(!std::is_void_v<In> || !std::is_void_v<Out>)
+class Stage : public PipelineStage {
+   protected:
+    using PipelineStage::PipelineStage;
+
+    StageInput<In> input_;
+    StageInput<Out>* output_ = nullptr;
+
+   private:
+    friend class Pipeline;
+
+    void open() final {
+        if constexpr (!std::is_void_v<Out>) {
+            if (output_ == nullptr) {
+                throw std::logic_error("Pipeline stage '" + name() + "' has no consumer");
+            }
+        }
+        if constexpr (!std::is_void_v<In>) {
+            if (input_.producers == 0) {
+                throw std::logic_error("Pipeline stage '" + name() + "' has no producer");
+            }
+            input_.channel = std::make_unique<PipelineChannel<In>>(options().queue_capacity, input_.producers,
+                                                                   options().parallelism, options().wait);
+        }
+    }
+
+    void close_output() final {
+        if constexpr (!std::is_void_v<Out>) {
+            output_->channel->close();
+        }
+    }
+
+    void input_stats(StageStats& stats) const final {
+        if constexpr (!std::is_void_v<In>) {
+            stats.queue_depth = input_.channel->approx_size();
+            stats.queue_capacity = input_.channel->capacity();
+            stats.queue_kind = input_.channel->kind();
+        }
+    }
+};
+
+// Stage running the user's callable F:
+// - source: bool(Emitter<Out>&), called until it returns false or the pipeline stops
+// - stage:  void(In&&, Emitter<Out>&), may emit any number of items per input
+// - sink:   void(In&&)
+template <typename In, typename Out, typename F>
+class StageImpl final : public Stage<In, Out> {
+   public:
+    StageImpl(std::string name, const StageOptions& options, F fn)
+        : Stage<In, Out>(std::move(name), options), fn_(std::move(fn)) {}
+
+   private:
+    void run(size_t replica, const std::atomic<bool>& stopping) override {
+        auto& counters = this->counters(replica);
+        if constexpr (std::is_void_v<In>) {
+            Emitter<Out> emit(*this->output_->channel, counters.out);
+            while (!stopping.load(std::memory_order_relaxed) && fn_(emit)) {
+            }
+        } else {
+            PipelineChannel<In>& input = *this->input_.channel;
+            while (std::optional<In> item = input.pop()) {
+                counters.in.store(counters.in.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                if constexpr (std::is_void_v<Out>) {
+                    fn_(std::move(*item));
+                } else {
+                    Emitter<Out> emit(*this->output_->channel, counters.out);
+                    fn_(std::move(*item), emit);
+                }
+            }
+        }
+    }
+
+    F fn_;
+};
+
+// Multi-stage processing graph (decode -> enrich -> route -> encode). Each stage runs on its own threads, pinned
+// to cores on request, and stages are connected by bounded queues chosen per edge: SPSC when exactly one thread
+// produces into and one consumes from the edge, MPMC otherwise. Several stages may feed one stage (fan-in); a
+// stage with parallelism > 1 load-balances its input over its threads.
+//
+// Sources end the run: once every source returned false (or stop() was called), each stage drains its input and
+// finishes in turn. Stages must only be added and connected before start().
+class Pipeline {
+   public:
+    Pipeline() = default;
+
+    ~Pipeline() {
+        if (started_) {
+            stop();
+            wait();
+        }
+    }
+
+    template <typename Out, typename F>
+    requires std::invocable<F&, Emitter<Out>&>
+    Stage<void, Out>& add_source(std::string name, F fn, const StageOptions& options = {}) {
+        return add<void, Out>(std::move(name), std::move(fn), options);
+    }
+
+    template <typename In, typename Out, typename F>
+    requires std::invocable<F&, In&&, Emitter<Out>&>
+    Stage<In, Out>& add_stage(std::string name, F fn, const StageOptions& options = {}) {
+        return add<In, Out>(std::move(name), std::move(fn), options);
+    }
+
+    template <typename In, typename F>
+    requires std::invocable<F&, In&&>
+    Stage<In, void>& add_sink(std::string name, F fn, const StageOptions& options = {}) {
+        return add<In, void>(std::move(name), std::move(fn), options);
+    }
+
+    // Routes everything `from` emits into `to`. A stage has at most one consumer.
+    template <typename A, typename B, typename C>
+    void connect(Stage<A, B>& from, Stage<B, C>& to) {
+        if (from.output_ != nullptr) {
+            throw std::logic_error("Pipeline stage '" + from.name() + "' is already connected");
+        }
+        from.output_ = &to.input_;
+        to.input_.producers += from.options().parallelism;
+    }
+
+    // Creates the queues and launches every stage's threads
+    void start() {
+        if (started_) {
+            throw std::logic_error("Pipeline already started");
+        }
+        for (auto& stage : stages_) {
+            stage->open();
+        }
+        started_ = true;
+        start_time_ = std::chrono::steady_clock::now();
+        for (auto& stage : stages_) {
+            stage->running_.store(stage->options().parallelism, std::memory_order_relaxed);
+        }
+        for (auto& stage : stages_) {
+            for (size_t replica = 0; replica < stage->options().parallelism; ++replica) {
+                threads_.emplace_back([this, s = stage.get(), replica] { run_replica(*s, replica); });
+            }
+        }
+    }
+
+    // Asks the sources to stop; the rest of the graph drains what is already queued
+    void stop() noexcept { stopping_.store(true, std::memory_order_relaxed); }
+
+    // Blocks until every stage finished
+    void wait() {
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+        threads_.clear();
+    }
+
+    [[nodiscard]] bool finished() const noexcept {
+        for (const auto& stage : stages_) {
+            if (stage->running_.load(std::memory_order_acquire) > 0) {
+                return false;
+            }
+        }
+        return started_;
+    }
+
+    // Per-stage throughput and queue depth; may be called while running
+    [[nodiscard]] std::vector<StageStats> stats() const {
+        const int64_t now = nanoseconds_since_epoch(std::chrono::steady_clock::now());
+        const int64_t start = nanoseconds_since_epoch(start_time_);
+        std::vector<StageStats> result;
+        for (const auto& stage : stages_) {
+            StageStats stats;
+            stats.name = stage->name();
+            stats.parallelism = stage->options().parallelism;
+            for (size_t i = 0; i < stats.parallelism; ++i) {
+                stats.items_in += stage->counters_[i].in.load(std::memory_order_relaxed);
+                stats.items_out += stage->counters_[i].out.load(std::memory_order_relaxed);
+            }
+            if (started_) {
+                const int64_t finished_at = stage->finished_at_.load(std::memory_order_relaxed);
+                stats.seconds = static_cast<double>((finished_at != 0 ? finished_at : now) - start) / 1e9;
+                stage->input_stats(stats);
+            }
+            result.push_back(std::move(stats));
+        }
+        return result;
+    }
+
+    // Delete copy/move constructors and assignment operators
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+    Pipeline(Pipeline&&) = delete;
+    Pipeline& operator=(Pipeline&&) = delete;
+
+   private:
+    template <typename In, typename Out, typename F>
+    Stage<In, Out>& add(std::string name, F fn, const StageOptions& options) {
+        if (started_) {
+            throw std::logic_error("Pipeline stages must be added before start()");
+        }
+        auto stage = std::make_unique<StageImpl<In, Out, F>>(std::move(name), options, std::move(fn));
+        Stage<In, Out>& result = *stage;
+        stages_.push_back(std::move(stage));
+        return result;
+    }
+
+    void run_replica(PipelineStage& stage, size_t replica) {
+        if (stage.options().cpu >= 0) {
+            pin_current_thread(stage.options().cpu + static_cast<int>(replica));
+        }
+        stage.run(replica, stopping_);
+        stage.close_output();
+        if (stage.running_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            stage.finished_at_.store(nanoseconds_since_epoch(std::chrono::steady_clock::now()),
+                                     std::memory_order_relaxed);
+        }
+    }
+
+    // Best effort: a core that does not exist (or a platform without affinity) leaves the thread unpinned
+    static bool pin_current_thread(int cpu) noexcept {
+#if defined(__linux__)
+        if (cpu >= CPU_SETSIZE) {
+            return false;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+
+    static int64_t nanoseconds_since_epoch(std::chrono::steady_clock::time_point time) noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    std::vector<std::unique_ptr<PipelineStage>> stages_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stopping_{false};
+    bool started_ = false;
+    std::chrono::steady_clock::time_point start_time_;
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "futex.hpp"
+#include "spin_wait.hpp"
+
+namespace lockfreekit {
+
+// Queue locks for the slow paths that still need mutual exclusion (resizing, a flat combining queue's combiner
+// election). Waiters line up in a queue and each one spins on a cache line of its own, so a release touches one
+// waiter's line instead of every waiter re-reading and CASing the same word, and the lock is handed over in
+// FIFO order.
+// - McsLock (Mellor-Crummey & Scott 1991): each waiter spins on its own node; the releaser writes the
+//   successor's node.
+// - ClhLock (Craig; Landin & Hagersten 1994): each waiter spins on its predecessor's node and adopts it on
+//   release. The releaser writes only its own node, so there is no successor pointer to wait for.
+// - HybridMutex: an MCS queue whose waiters spin briefly and then park on a futex in their own node, and whose
+//   release hands the lock straight to the next waiter (no barging). For critical sections that may be long or
+//   machines that are oversubscribed, where the spin locks burn the CPU the holder needs.
+//
+// McsLock and HybridMutex are Lockable, ClhLock only BasicLockable: a CLH waiter cannot leave the queue, and a
+// try_lock that checked the tail could be fooled by the tail node being recycled. The owner must unlock. Queue
+// nodes come from a small per-thread pool, so the interface needs no node argument: the owner parks its node
+// in the lock while it holds it. The spin locks fall back to yielding after a while (SpinWait), like every
+// other wait loop here.
+
+// Queue node shared by the three locks: one cache line, taken from and returned to a per-thread pool
+struct alignas(64) QueueLockNode {
+    std::atomic<QueueLockNode*> next{nullptr};
+    std::atomic<uint32_t> state{0};
+    QueueLockNode* pool_next = nullptr;
+
+    // A node of the calling thread's pool, or a new one
+    static QueueLockNode* take() {
+        Pool& pool = pool_;
+        if (QueueLockNode* node = pool.head) {
+            pool.head = node->pool_next;
+            return node;
+        }
+        return new QueueLockNode;
+    }
+
+    // Returns a node nobody references anymore to the calling thread's pool
+    static void give(QueueLockNode* node) noexcept {
+        Pool& pool = pool_;
+        node->pool_next = pool.head;
+        pool.head = node;
+    }
+
+   private:
+    // No member initializer, the thread_local below is value-initialized
+    struct Pool {
+        QueueLockNode* head;
+
+        ~Pool() {
+            while (head != nullptr) {
+                delete std::exchange(head, head->pool_next);
+            }
+        }
+    };
+
+    inline static thread_local Pool pool_{};
+};
+
+class McsLock {
+   public:
+    McsLock() = default;
+
+    void lock() {
+        QueueLockNode* node = QueueLockNode::take();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->state.store(WAITING_, std::memory_order_relaxed);
+        // Acq_rel: acquire pairs with the previous holder's unlock when the queue was empty
+        if (QueueLockNode* predecessor = tail_.exchange(node, std::memory_order_acq_rel)) {
+            predecessor->next.store(node, std::memory_order_release);
+            for (SpinWait spin; node->state.load(std::memory_order_acquire) == WAITING_; spin.wait()) {
+            }
+        }
+        owner_ = node;
+    }
+
+    [[nodiscard]] bool try_lock() {
+        QueueLockNode* node = QueueLockNode::take();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        QueueLockNode* empty = nullptr;
+        if (!tail_.compare_exchange_strong(empty, node, std::memory_order_acquire, std::memory_order_relaxed)) {
+            QueueLockNode::give(node);
+            return false;
+        }
+        owner_ = node;
+        return true;
+    }
+
+    void unlock() noexcept {
+        QueueLockNode* node = owner_;
+        QueueLockNode* successor = node->next.load(std::memory_order_acquire);
+        if (successor == nullptr) {
+            QueueLockNode* expected = node;
+            if (tail_.compare_exchange_strong(expected, nullptr, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+                QueueLockNode::give(node);
+                return;
+            }
+            // A successor swapped itself in and is about to link
+            for (SpinWait spin; (successor = node->next.load(std::memory_order_acquire)) == nullptr; spin.wait()) {
+            }
+        }
+        successor->state.store(GRANTED_, std::memory_order_release);
+        QueueLockNode::give(node);  // The successor no longer touches it
+    }
+
+    // Delete copy/move constructors and assignment operators
+    McsLock(const McsLock&) = delete;
+    McsLock& operator=(const McsLock&) = delete;
+    McsLock(McsLock&&) = delete;
+    McsLock& operator=(McsLock&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static constexpr uint32_t GRANTED_ = 0;
+    static constexpr uint32_t WAITING_ = 1;
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<QueueLockNode*> tail_{nullptr};
+    QueueLockNode* owner_ = nullptr;  // Holder only
+    char pad0[CACHE_LINE_SIZE_ - sizeof(tail_) - sizeof(owner_)]{};
+};
+
+class ClhLock {
+   public:
+    ClhLock() : tail_(new QueueLockNode) {}  // Starts with a released node
+
+    // No thread may hold or wait for the lock anymore
+    ~ClhLock() { delete tail_.load(std::memory_order_relaxed); }
+
+    void lock() {
+        QueueLockNode* node = QueueLockNode::take();
+        node->state.store(HELD_, std::memory_order_relaxed);
+        // Release: publishes our node's state to the successor that will spin on it
+        QueueLockNode* predecessor = tail_.exchange(node, std::memory_order_acq_rel);
+        for (SpinWait spin; predecessor->state.load(std::memory_order_acquire) == HELD_; spin.wait()) {
+        }
+        owner_ = node;
+        owner_predecessor_ = predecessor;
+    }
+
+    void unlock() noexcept {
+        QueueLockNode* node = owner_;
+        // Nobody spins on the predecessor's node anymore: it becomes ours. Ours now belongs to the successor
+        // (or stays as the lock's tail).
+        QueueLockNode::give(owner_predecessor_);
+        node->state.store(RELEASED_, std::memory_order_release);
+    }
+
+    // Delete copy/move constructors and assignment operators
+    ClhLock(const ClhLock&) = delete;
+    ClhLock& operator=(const ClhLock&) = delete;
+    ClhLock(ClhLock&&) = delete;
+    ClhLock& operator=(ClhLock&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static constexpr uint32_t RELEASED_ = 0;
+    static constexpr uint32_t HELD_ = 1;
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<QueueLockNode*> tail_;
+    // Holder only
+    QueueLockNode* owner_ = nullptr;
+    QueueLockNode* owner_predecessor_ = nullptr;
+    char pad0[CACHE_LINE_SIZE_ - sizeof(tail_) - 2 * sizeof(QueueLockNode*)]{};
+};
+
+class HybridMutex {
+   public:
+    static constexpr uint32_t SPINS_BEFORE_PARK = 128;
+
+    HybridMutex() = default;
+
+    void lock() {
+        QueueLockNode* node = QueueLockNode::take();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->state.store(WAITING_, std::memory_order_relaxed);
+        if (QueueLockNode* predecessor = tail_.exchange(node, std::memory_order_acq_rel)) {
+            predecessor->next.store(node, std::memory_order_release);
+            wait_for_handoff(*node);
+        }
+        owner_ = node;
+    }
+
+    [[nodiscard]] bool try_lock() {
+        QueueLockNode* node = QueueLockNode::take();
+        node->next.store(nullptr, std::memory_order_relaxed);
+        QueueLockNode* empty = nullptr;
+        if (!tail_.compare_exchange_strong(empty, node, std::memory_order_acquire, std::memory_order_relaxed)) {
+            QueueLockNode::give(node);
+            return false;
+        }
+        owner_ = node;
+        return true;
+    }
+
+    void unlock() noexcept {
+        QueueLockNode* node = owner_;
+        QueueLockNode* successor = node->next.load(std::memory_order_acquire);
+        if (successor == nullptr) {
+            QueueLockNode* expected = node;
+            if (tail_.compare_exchange_strong(expected, nullptr, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+                QueueLockNode::give(node);
+                return;
+            }
+            // The successor is between its exchange and its link: a few instructions, spinning is right
+            for (SpinWait spin; (successor = node->next.load(std::memory_order_acquire)) == nullptr; spin.wait()) {
+            }
+        }
+        QueueLockNode::give(node);
+        // Hand over. Only a parked successor needs the syscall; it may already be running when the wake-up
+        // arrives (it saw GRANTED before sleeping), which futex tolerates: at worst a spurious wake-up for
+        // whoever sleeps on that address later.
+        if (successor->state.exchange(GRANTED_, std::memory_order_release) == PARKED_) {
+            futex_wake(successor->state, 1);
+        }
+    }
+
+    // Delete copy/move constructors and assignment operators
+    HybridMutex(const HybridMutex&) = delete;
+    HybridMutex& operator=(const HybridMutex&) = delete;
+    HybridMutex(HybridMutex&&) = delete;
+    HybridMutex& operator=(HybridMutex&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static constexpr uint32_t GRANTED_ = 0;
+    static constexpr uint32_t WAITING_ = 1;
+    static constexpr uint32_t PARKED_ = 2;
+
+    static void wait_for_handoff(QueueLockNode& node) noexcept {
+        for (uint32_t spins = 0; spins < SPINS_BEFORE_PARK; ++spins) {
+            if (node.state.load(std::memory_order_acquire) == GRANTED_) {
+                return;
+            }
+            cpu_relax();
+        }
+        uint32_t waiting = WAITING_;
+        if (!node.state.compare_exchange_strong(waiting, PARKED_, std::memory_order_acquire,
+                                                std::memory_order_relaxed)) {
+            return;  // Granted meanwhile
+        }
+        // Waits may return spuriously; the handoff is the only way out
+        while (node.state.load(std::memory_order_acquire) != GRANTED_) {
+            futex_wait(node.state, PARKED_);
+        }
+    }
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<QueueLockNode*> tail_{nullptr};
+    QueueLockNode* owner_ = nullptr;  // Holder only
+    char pad0[CACHE_LINE_SIZE_ - sizeof(tail_) - sizeof(owner_)]{};
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "mpmc_queue.hpp"
+#include "spin_wait.hpp"
+
+namespace lockfreekit {
+
+// Wait on any of N MPMCQueues without polling them (select()).
+//
+// The set keeps a readiness bitmap with one bit per registered queue. A producer that enqueues through the set
+// (or calls notify() after enqueueing directly) sets the queue's bit, and wakes a parked consumer when it turned
+// the bit on. A consumer scans the bitmap, starting at a rotating position for fairness, and only touches queues
+// whose bit is set. When every bit is clear it spins briefly, then parks.
+//
+// A consumer clears a bit before dequeuing and sets it again if the queue still has elements, so a bit can be
+// set for an empty queue (a wasted look) but never clear for a non-empty one.
+template <typename T, size_t static_capacity = 0, typename Index = size_t>
+requires QueueValue<T> && QueueIndex<Index>
+class QueueSet {
+   public:
+    using Queue = MPMCQueue<T, static_capacity, Index>;
+
+    struct Selected {
+        size_t queue;  // Id returned by add()
+        T value;
+    };
+
+    explicit QueueSet(size_t max_queues)
+        : max_queues_(max_queues), words_((max_queues + WORD_BITS_ - 1) / WORD_BITS_),
+          ready_(std::make_unique<std::atomic<uint64_t>[]>(words_)) {
+        if (max_queues_ < 1) {
+            throw std::invalid_argument("QueueSet needs room for at least one queue");
+        }
+        queues_.reserve(max_queues_);
+    }
+
+    // Registers `queue` and returns its id. All queues must be added before the set is used.
+    size_t add(Queue& queue) {
+        if (queues_.size() == max_queues_) {
+            throw std::length_error("QueueSet is full");
+        }
+        queues_.push_back(&queue);
+        return queues_.size() - 1;
+    }
+
+    // Enqueues into queue `id` and flags it ready. Returns false if that queue is full.
+    [[nodiscard]] bool enqueue(size_t id, const T& value) {
+        if (!queues_[id]->enqueue(value)) {
+            return false;
+        }
+        notify(id);
+        return true;
+    }
+
+    // For producers that enqueued into queue `id` directly
+    void notify(size_t id) {
+        std::atomic<uint64_t>& word = ready_[id / WORD_BITS_];
+        const uint64_t bit = uint64_t{1} << (id % WORD_BITS_);
+        // Pairs with the fence in try_take(): either we see the bit cleared and set it again, or the consumer
+        // that cleared it sees our element
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if ((word.load(std::memory_order_relaxed) & bit) != 0) {
+            return;  // Already flagged, whoever clears it will look at the queue
+        }
+        // Seq_cst load after the seq_cst fetch_or, against select()'s sleepers_ increment and fence: either we
+        // see the consumer sleeping, or it sees our bit
+        if ((word.fetch_or(bit, std::memory_order_seq_cst) & bit) == 0 &&
+            sleepers_.load(std::memory_order_seq_cst) > 0) {
+            epoch_.fetch_add(1, std::memory_order_release);
+            epoch_.notify_one();
+        }
+    }
+
+    // An element from some ready queue, or nullopt if every queue looked empty
+    [[nodiscard]] std::optional<Selected> try_select() {
+        const size_t count = queues_.size();
+        if (count == 0) {
+            return std::nullopt;
+        }
+        // Rotate the starting point so that low ids do not starve the others
+        const size_t start = rotation_.fetch_add(1, std::memory_order_relaxed) % count;
+        for (size_t word_offset = 0; word_offset <= words_; ++word_offset) {
+            const size_t w = (start / WORD_BITS_ + word_offset) % words_;
+            uint64_t bits = ready_[w].load(std::memory_order_relaxed);
+            // The start word is visited twice: bits from `start` up first, the ones below it last
+            if (word_offset == 0) {
+                bits &= ~uint64_t{0} << (start % WORD_BITS_);
+            } else if (word_offset == words_) {
+                bits &= (uint64_t{1} << (start % WORD_BITS_)) - 1;
+            }
+            while (bits != 0) {
+                const size_t id = w * WORD_BITS_ + static_cast<size_t>(std::countr_zero(bits));
+                bits &= bits - 1;
+                if (auto value = try_take(id)) {
+                    return Selected{id, std::move(*value)};
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Waits for an element from any queue. Returns nullopt only after close(), once every queue is empty.
+    [[nodiscard]] std::optional<Selected> select() {
+        SpinWait spin;
+        uint32_t idle = 0;
+        for (;;) {
+            if (auto selected = try_select()) {
+                return selected;
+            }
+            if (closed_.load(std::memory_order_acquire)) {
+                return try_select();
+            }
+            if (++idle < IDLE_SPINS_) {
+                spin.wait();
+                continue;
+            }
+            idle = 0;
+            const uint32_t epoch = epoch_.load(std::memory_order_acquire);
+            sleepers_.fetch_add(1, std::memory_order_relaxed);
+            // Pairs with notify(): either we see its bit, or it sees us sleeping
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!any_ready() && !closed_.load(std::memory_order_acquire)) {
+                epoch_.wait(epoch, std::memory_order_acquire);
+            }
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Wakes every consumer parked in select(); after the queues drain, select() returns nullopt
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        epoch_.fetch_add(1, std::memory_order_release);
+        epoch_.notify_all();
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return queues_.size(); }
+
+    // Delete copy/move constructors and assignment operators
+    QueueSet(const QueueSet&) = delete;
+    QueueSet& operator=(const QueueSet&) = delete;
+    QueueSet(QueueSet&&) = delete;
+    QueueSet& operator=(QueueSet&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static constexpr size_t WORD_BITS_ = 64;
+    // Empty scans before select() parks
+    static constexpr uint32_t IDLE_SPINS_ = 128;
+
+    std::optional<T> try_take(size_t id) {
+        std::atomic<uint64_t>& word = ready_[id / WORD_BITS_];
+        const uint64_t bit = uint64_t{1} << (id % WORD_BITS_);
+        if ((word.fetch_and(~bit, std::memory_order_seq_cst) & bit) == 0) {
+            return std::nullopt;  // Another consumer took the flag
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::optional<T> value = queues_[id]->dequeue();
+        if (!queues_[id]->empty()) {
+            word.fetch_or(bit, std::memory_order_relaxed);  // More left: keep the queue flagged
+        }
+        return value;
+    }
+
+    [[nodiscard]] bool any_ready() const noexcept {
+        for (size_t w = 0; w < words_; ++w) {
+            if (ready_[w].load(std::memory_order_relaxed) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const size_t max_queues_;
+    const size_t words_;
+    std::vector<Queue*> queues_;
+    std::unique_ptr<std::atomic<uint64_t>[]> ready_;
+    std::atomic<bool> closed_{false};
+
+    // Any consumer; kept off the lines producers touch
+    alignas(CACHE_LINE_SIZE_) std::atomic<size_t> rotation_{0};
+    char pad0[CACHE_LINE_SIZE_ - sizeof(rotation_)]{};
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<uint32_t> sleepers_{0};
+    std::atomic<uint32_t> epoch_{0};
+    char pad1[CACHE_LINE_SIZE_ - sizeof(sleepers_) - sizeof(epoch_)]{};
+};
+
+}  // namespace lockfreekit
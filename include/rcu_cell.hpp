@@ -0,0 +1,286 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "spin_wait.hpp"
+
+namespace lockfreekit {
+
+enum class RcuMode {
+    epoch,  // Readers bracket each access with read(); no other duty
+    qsbr,   // Readers access freely and report quiescent states from their main loop
+};
+
+// Read-copy-update cell for read-mostly data (routing tables, configuration). Readers get a plain pointer to
+// the current copy; a writer publishes a new copy with one pointer store and frees the old one only after a
+// grace period, once no reader can still be looking at it.
+//
+// Every reader thread registers a Reader handle, holding a state word only that thread writes. A grace period
+// bumps the global epoch and waits until every reader is outside a read-side critical section (state 0) or
+// has entered one since (state >= the new epoch).
+// - epoch mode: read() stores the epoch in the state word and returns a guard that stores 0 again. No atomic
+//   read-modify-write. On Linux the store-load fence it needs is moved to the writer with membarrier(2),
+//   which makes every running reader thread execute one; readers then only need a compiler barrier.
+//   Without membarrier readers pay a fence.
+// - qsbr mode: get() is a bare pointer load. The pointer stays valid until the reader's next quiescent() or
+//   offline(), which a worker calls at natural points (between messages). A reader that blocks should go
+//   offline() first, or it stalls writers.
+//
+// Writers are rare and take a mutex among themselves. update() waits for the grace period itself; publish()
+// defers the old copy to a later reclaim(). In qsbr mode a writer thread that is also a registered reader has
+// to be offline while it waits.
+template <typename T, RcuMode mode = RcuMode::epoch>
+class RcuCell {
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+
+   public:
+    class Reader {
+       public:
+        Reader() = default;
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+       private:
+        friend class RcuCell;
+
+        alignas(CACHE_LINE_SIZE_) std::atomic<uint64_t> state_{0};  // 0: not reading / offline
+        uint32_t nesting_ = 0;                                        // Owner only, epoch mode
+    };
+
+    // Epoch mode read-side critical section. Nested guards on the same reader are fine.
+    class ReadGuard {
+       public:
+        ~ReadGuard() { cell_.read_unlock(reader_); }
+
+        const T* get() const noexcept { return value_; }
+        const T* operator->() const noexcept { return value_; }
+        const T& operator*() const noexcept { return *value_; }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+       private:
+        friend class RcuCell;
+        ReadGuard(RcuCell& cell, Reader& reader) : cell_(cell), reader_(reader) {
+            cell_.read_lock(reader_);
+            value_ = cell_.current_.load(std::memory_order_acquire);
+        }
+
+        RcuCell& cell_;
+        Reader& reader_;
+        const T* value_ = nullptr;
+    };
+
+    RcuCell(std::unique_ptr<T> initial, size_t max_readers)
+        : max_readers_(max_readers), readers_(std::make_unique<Reader[]>(max_readers)), current_(initial.release()) {
+        if (current_.load(std::memory_order_relaxed) == nullptr) {
+            throw std::invalid_argument("RcuCell needs an initial value");
+        }
+    }
+
+    // No reader may be active anymore
+    ~RcuCell() {
+        delete current_.load(std::memory_order_relaxed);
+        for (const Retired& retired : retired_) {
+            delete retired.value;
+        }
+    }
+
+    // Every reader thread calls this once and keeps the handle. A qsbr reader starts online.
+    [[nodiscard]] Reader& register_reader() {
+        const size_t index = registered_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= max_readers_) {
+            throw std::runtime_error("RcuCell: too many readers");
+        }
+        Reader& reader = readers_[index];
+        if constexpr (mode == RcuMode::qsbr) {
+            online(reader);
+        }
+        return reader;
+    }
+
+    // --- Readers, epoch mode ---
+
+    [[nodiscard]] ReadGuard read(Reader& reader) requires(mode == RcuMode::epoch) { return ReadGuard(*this, reader); }
+
+    // --- Readers, qsbr mode ---
+
+    // Valid until the calling reader's next quiescent() or offline()
+    [[nodiscard]] const T* get() const noexcept requires(mode == RcuMode::qsbr) {
+        return current_.load(std::memory_order_acquire);
+    }
+
+    // The reader holds no pointer obtained before this call
+    void quiescent(Reader& reader) noexcept requires(mode == RcuMode::qsbr) {
+        // Release: our reads of old copies are done. Acquire: a writer that sees the new epoch here knows we
+        // see its new pointer from now on.
+        reader.state_.store(epoch_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // The reader will not touch the cell until online(); writers stop waiting for it
+    void offline(Reader& reader) noexcept requires(mode == RcuMode::qsbr) {
+        reader.state_.store(0, std::memory_order_release);
+    }
+
+    void online(Reader& reader) noexcept requires(mode == RcuMode::qsbr) {
+        reader.state_.store(epoch_.load(std::memory_order_acquire), std::memory_order_relaxed);
+        // Pairs with the writer's barrier: either it sees us online, or we see its new pointer
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    // --- Writers ---
+
+    // Publishes `fresh`, waits for a grace period and frees the old copy
+    void update(std::unique_ptr<T> fresh) {
+        std::unique_ptr<T> old;
+        {
+            std::lock_guard lock(writer_mutex_);
+            old.reset(replace(std::move(fresh)));
+        }
+        synchronize();
+    }
+
+    // Copies the current value, lets `change` edit the copy and publishes it. The writer lock is held from
+    // the copy to the publication, so concurrent modify() calls never build on the same old value.
+    template <typename Change>
+    void modify(Change&& change) {
+        std::unique_ptr<T> old;
+        {
+            std::lock_guard lock(writer_mutex_);
+            auto copy = std::make_unique<T>(*current_.load(std::memory_order_relaxed));
+            change(*copy);
+            old.reset(replace(std::move(copy)));
+        }
+        synchronize();
+    }
+
+    // Publishes `fresh` without waiting; the old copy is freed by a reclaim() after its grace period
+    void publish(std::unique_ptr<T> fresh) {
+        std::lock_guard lock(writer_mutex_);
+        T* old = replace(std::move(fresh));
+        retired_.push_back(Retired{old, epoch_.fetch_add(1, std::memory_order_acq_rel) + 1});
+    }
+
+    // Frees the published-over copies whose grace period has passed, without waiting; returns how many
+    size_t reclaim() {
+        std::lock_guard lock(writer_mutex_);
+        if (retired_.empty()) {
+            return 0;
+        }
+        heavy_barrier();
+        uint64_t oldest = std::numeric_limits<uint64_t>::max();
+        for (size_t i = 0; i < max_readers_; ++i) {
+            if (const uint64_t state = readers_[i].state_.load(std::memory_order_acquire); state != 0) {
+                oldest = std::min(oldest, state);
+            }
+        }
+        const auto safe = std::stable_partition(retired_.begin(), retired_.end(),
+                                                [&](const Retired& retired) { return retired.epoch > oldest; });
+        const auto freed = static_cast<size_t>(retired_.end() - safe);
+        for (auto it = safe; it != retired_.end(); ++it) {
+            delete it->value;
+        }
+        retired_.erase(safe, retired_.end());
+        return freed;
+    }
+
+    // Waits until every read-side critical section that could see a copy replaced before the call has ended
+    void synchronize() {
+        const uint64_t target = epoch_.fetch_add(1, std::memory_order_acq_rel) + 1;
+        heavy_barrier();
+        for (size_t i = 0; i < max_readers_; ++i) {
+            for (SpinWait spin;; spin.wait()) {
+                const uint64_t state = readers_[i].state_.load(std::memory_order_acquire);
+                if (state == 0 || state >= target) {
+                    break;
+                }
+            }
+        }
+    }
+
+    // Delete copy/move constructors and assignment operators
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+    RcuCell(RcuCell&&) = delete;
+    RcuCell& operator=(RcuCell&&) = delete;
+
+   private:
+    struct Retired {
+        T* value;
+        uint64_t epoch;  // Safe once every active reader is at this epoch or later
+    };
+
+    void read_lock(Reader& reader) noexcept {
+        if (reader.nesting_++ == 0) {
+            // Acquire: a reader that sees the new epoch sees the pointer published before it
+            reader.state_.store(epoch_.load(std::memory_order_acquire), std::memory_order_relaxed);
+            // Store-load barrier before the pointer load; the writer supplies it with membarrier if it can
+            if (fast_readers_) {
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+            } else {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+    }
+
+    void read_unlock(Reader& reader) noexcept {
+        if (--reader.nesting_ == 0) {
+            reader.state_.store(0, std::memory_order_release);  // Our reads happen before the writer frees
+        }
+    }
+
+    // Caller holds writer_mutex_. Swaps `fresh` in and returns the copy it replaced, still visible to readers.
+    T* replace(std::unique_ptr<T> fresh) noexcept {
+        return current_.exchange(fresh.release(), std::memory_order_acq_rel);
+    }
+
+    // Orders the epoch bump before the reader scan, against every reader's state store
+    void heavy_barrier() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+#if defined(__linux__)
+        if (fast_readers_) {
+            syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+        }
+#endif
+    }
+
+    // Registers the process for expedited membarrier once; false where that is unavailable. Thread sanitizer
+    // cannot see membarrier's ordering, so sanitized builds keep the reader fences.
+    static bool membarrier_available() noexcept {
+#if defined(__linux__) && !defined(__SANITIZE_THREAD__)
+        static const bool available =
+            syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+        return available;
+#else
+        return false;
+#endif
+    }
+
+    const size_t max_readers_;
+    std::unique_ptr<Reader[]> readers_;
+    std::atomic<size_t> registered_{0};
+    const bool fast_readers_ = mode == RcuMode::epoch && membarrier_available();
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<T*> current_;
+    alignas(CACHE_LINE_SIZE_) std::atomic<uint64_t> epoch_{1};
+    char pad0[CACHE_LINE_SIZE_ - sizeof(epoch_)]{};
+
+    std::mutex writer_mutex_;
+    std::vector<Retired> retired_;  // Guarded by writer_mutex_
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "mpmc_queue.hpp"
+#include "spin_wait.hpp"
+
+namespace lockfreekit {
+
+// Restores sequence order behind a stage that N workers run in parallel (e.g. all pulling from one MPMCQueue).
+//
+// Items carry the sequence number they had before the fan-out. Workers insert each finished item into the slot
+// for its sequence in a ring of `window` slots; one consumer releases the contiguous prefix in order. A worker
+// whose item is `window` or more ahead of the consumer waits for the consumer (backpressure), so at most `window`
+// items are ever held back. Every sequence must be inserted exactly once.
+//
+// The slots work like MPMCQueue's: a slot's sequence is `s` while it is free for item `s` and `s + 1` once item
+// `s` is in it. Sequence numbers are distinct, so inserting needs no CAS.
+template <typename T>
+requires QueueValue<T>
+class ReorderBuffer {
+   public:
+    explicit ReorderBuffer(size_t window, uint64_t first_sequence = 0)
+        : window_(window), slots_(window), next_(first_sequence) {
+        if (window_ < 1) {
+            throw std::invalid_argument("Reorder window must be > 0");
+        }
+        for (size_t i = 0; i < window_; ++i) {
+            // Slot i first serves the first sequence that maps to it
+            const uint64_t offset = (i + window_ - first_sequence % window_) % window_;
+            slots_[i].sequence.store(first_sequence + offset, std::memory_order_relaxed);
+        }
+    }
+
+    // Any thread. Returns false if `sequence` is `window` or more ahead of the consumer.
+    [[nodiscard]] bool try_insert(uint64_t sequence, const T& value) {
+        Slot& slot = slots_[sequence % window_];
+        // Acquire: the consumer has moved the previous value out before freeing the slot for us
+        if (slot.sequence.load(std::memory_order_acquire) != sequence) {
+            return false;  // Window full
+        }
+        slot.value = value;
+        slot.sequence.store(sequence + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Any thread. Waits while the window is full. Must not be called from the consumer thread, which is the one
+    // that has to make room.
+    void insert(uint64_t sequence, const T& value) {
+        for (SpinWait spin; !try_insert(sequence, value);) {
+            spin.wait();
+        }
+    }
+
+    // Consumer only. The next item in sequence order, or nullopt if it has not been inserted yet.
+    [[nodiscard]] std::optional<T> try_pop() {
+        const uint64_t next = next_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[next % window_];
+        // Acquire pairs with the worker's release store, the value is visible
+        if (slot.sequence.load(std::memory_order_acquire) != next + 1) {
+            return std::nullopt;
+        }
+        T value = std::move(slot.value);
+        slot.sequence.store(next + window_, std::memory_order_release);
+        next_.store(next + 1, std::memory_order_relaxed);
+        return value;
+    }
+
+    // Consumer only. Passes the contiguous prefix of ready items to `sink` in order; returns how many there were.
+    template <typename Sink>
+    size_t release(Sink&& sink) {
+        size_t released = 0;
+        while (std::optional<T> value = try_pop()) {
+            sink(std::move(*value));
+            ++released;
+        }
+        return released;
+    }
+
+    // Sequence of the item the consumer waits for
+    [[nodiscard]] uint64_t next_sequence() const noexcept { return next_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] size_t window() const noexcept { return window_; }
+
+    // Delete copy/move constructors and assignment operators
+    ReorderBuffer(const ReorderBuffer&) = delete;
+    ReorderBuffer& operator=(const ReorderBuffer&) = delete;
+    ReorderBuffer(ReorderBuffer&&) = delete;
+    ReorderBuffer& operator=(ReorderBuffer&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        T value;
+    };
+
+    const size_t window_;
+    std::vector<Slot> slots_;
+
+    // Written by the consumer only; atomic so that next_sequence() may be read elsewhere
+    alignas(CACHE_LINE_SIZE_) std::atomic<uint64_t> next_;
+    char pad0[CACHE_LINE_SIZE_ - sizeof(next_)]{};
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace lockfreekit {
+
+// Statistics counter for hot paths: add() touches a cache line shared only by the threads striped onto the same
+// cell, instead of one atomic every thread fights over.
+//
+// Each cell accumulates locally and folds into a central total once its magnitude reaches `batch`, the way the
+// Linux percpu_counter does. approx() reads only the central total, O(1) and off by at most cells * batch;
+// sum() adds up every cell, exact whenever no add() is in flight.
+//
+// Threads are striped over the cells by a sequential per-thread id rather than by CPU: that needs no
+// sched_getcpu() call per add and a thread never migrates between cells.
+class ShardedCounter {
+   public:
+    static constexpr int64_t DEFAULT_BATCH = 64;
+
+    // `cells` is rounded up to a power of two; 0 means one per hardware thread
+    explicit ShardedCounter(size_t cells = 0, int64_t batch = DEFAULT_BATCH)
+        : cell_count_(std::bit_ceil(cells > 0 ? cells : std::max<size_t>(std::thread::hardware_concurrency(), 1))),
+          batch_(batch),
+          cells_(std::make_unique<Cell[]>(cell_count_)) {
+        if (batch_ < 1) {
+            throw std::invalid_argument("ShardedCounter batch must be > 0");
+        }
+    }
+
+    void add(int64_t delta) noexcept {
+        Cell& cell = cells_[thread_stripe() & (cell_count_ - 1)];
+        const int64_t local = cell.value.fetch_add(delta, std::memory_order_relaxed) + delta;
+        if (local >= batch_ || local <= -batch_) {
+            // Central first: a concurrent sum() may count `local` twice for a moment, but never loses it
+            central_.fetch_add(local, std::memory_order_relaxed);
+            cell.value.fetch_sub(local, std::memory_order_relaxed);
+        }
+    }
+
+    void increment() noexcept { add(1); }
+    void decrement() noexcept { add(-1); }
+
+    // Cheap estimate, within cells() * batch of the true value
+    [[nodiscard]] int64_t approx() const noexcept { return central_.load(std::memory_order_relaxed); }
+
+    // Reads every cell; exact when no add() runs concurrently
+    [[nodiscard]] int64_t sum() const noexcept {
+        int64_t total = central_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < cell_count_; ++i) {
+            total += cells_[i].value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    [[nodiscard]] size_t cells() const noexcept { return cell_count_; }
+
+    // Delete copy/move constructors and assignment operators
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+    ShardedCounter(ShardedCounter&&) = delete;
+    ShardedCounter& operator=(ShardedCounter&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+
+    struct alignas(CACHE_LINE_SIZE_) Cell {
+        std::atomic<int64_t> value{0};
+    };
+
+    // Sequential, so that the first threads land on distinct cells
+    static size_t thread_stripe() noexcept {
+        static std::atomic<size_t> next{0};
+        static thread_local const size_t stripe = next.fetch_add(1, std::memory_order_relaxed);
+        return stripe;
+    }
+
+    const size_t cell_count_;
+    const int64_t batch_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<int64_t> central_{0};
+    char pad0[CACHE_LINE_SIZE_ - sizeof(central_)]{};
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lockfreekit {
+
+// Size-class slab allocator for pipelines where one thread allocates and another frees, modeled on mimalloc's
+// sharded free lists.
+//
+// Every thread gets its own heap of PAGE_BYTES pages, each page carved into blocks of one size class. A page is
+// aligned to its size, so free() finds the page header by masking the pointer. Then:
+// - the owning thread pushes the block on the page's plain local free list;
+// - any other thread pushes it on the page's remote free list, an intrusive MPSC stack (one CAS, no lock);
+// - the owner takes a page's whole remote list with one exchange when its local list runs dry, so remote frees
+//   come back in batches and the owner never synchronizes per block.
+//
+// Requests above MAX_SMALL get a page of their own, freed directly. A thread that exits detaches its heap and
+// the next new thread adopts it, pages and pending remote frees included. Pages are returned to the system
+// only when the allocator is destroyed, which must happen after every block was freed.
+class SlabAllocator {
+   public:
+    static constexpr size_t PAGE_BYTES = 64 * 1024;
+    static constexpr size_t MAX_SMALL = 4096;
+
+    SlabAllocator() = default;
+
+    ~SlabAllocator() {
+        for (Heap* heap = heaps_.load(std::memory_order_acquire); heap != nullptr;) {
+            Heap* next = heap->next;
+            for (Page* page : heap->pages) {
+                while (page != nullptr) {
+                    Page* next_page = page->next;
+                    free_page(page);
+                    page = next_page;
+                }
+            }
+            drop(heap);
+            heap = next;
+        }
+    }
+
+    // Blocks are 16-byte aligned
+    [[nodiscard]] void* allocate(size_t bytes) {
+        if (bytes > MAX_SMALL) {
+            return allocate_large(bytes);
+        }
+        Heap& heap = local_heap();
+        const size_t size_class = class_of(std::max<size_t>(bytes, 1));
+        if (Page* page = heap.current[size_class]; page != nullptr) {
+            if (Block* block = page->local_free; block != nullptr) {
+                page->local_free = block->next;
+                return block;
+            }
+        }
+        return allocate_slow(heap, size_class);
+    }
+
+    // Any thread
+    void deallocate(void* pointer) noexcept {
+        if (pointer == nullptr) {
+            return;
+        }
+        Page* page = page_of(pointer);
+        if (page->large) {
+            free_page(page);
+            return;
+        }
+        auto* block = static_cast<Block*>(pointer);
+        if (page->heap == cached_heap()) {
+            block->next = page->local_free;
+            page->local_free = block;
+            return;
+        }
+        // Release: our writes to the block happen before the owner hands it out again
+        Block* head = page->remote_free.load(std::memory_order_relaxed);
+        do {
+            block->next = head;
+        } while (!page->remote_free.compare_exchange_weak(head, block, std::memory_order_release,
+                                                          std::memory_order_relaxed));
+    }
+
+    template <typename T, typename... Args>
+    [[nodiscard]] T* create(Args&&... args) {
+        static_assert(alignof(T) <= ALIGNMENT_, "SlabAllocator blocks are only 16-byte aligned");
+        void* memory = allocate(sizeof(T));
+        try {
+            return ::new (memory) T(std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(memory);
+            throw;
+        }
+    }
+
+    template <typename T>
+    void destroy(T* object) noexcept {
+        if (object != nullptr) {
+            object->~T();
+            deallocate(object);
+        }
+    }
+
+    // Heaps created so far, attached or waiting for adoption
+    [[nodiscard]] size_t heap_count() const noexcept { return heap_count_.load(std::memory_order_relaxed); }
+
+    // Block size a request of `bytes` is served from, for requests up to MAX_SMALL
+    [[nodiscard]] static constexpr size_t block_size(size_t bytes) noexcept {
+        return class_size(class_of(std::max<size_t>(bytes, 1)));
+    }
+
+    // Delete copy/move constructors and assignment operators
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+    SlabAllocator(SlabAllocator&&) = delete;
+    SlabAllocator& operator=(SlabAllocator&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static constexpr size_t ALIGNMENT_ = 16;
+
+    // 16-byte steps up to 128, then four classes per power of two up to MAX_SMALL
+    static constexpr size_t CLASSES_ = 8 + 4 * (std::bit_width(MAX_SMALL) - 1 - 7);
+
+    static constexpr size_t class_of(size_t bytes) noexcept {
+        if (bytes <= 128) {
+            return (bytes + ALIGNMENT_ - 1) / ALIGNMENT_ - 1;
+        }
+        const auto bits = static_cast<size_t>(std::bit_width(bytes - 1));  // 2^(bits-1) < bytes <= 2^bits
+        const size_t step = size_t{1} << (bits - 3);
+        return 8 + (bits - 8) * 4 + (bytes - 1 - (size_t{1} << (bits - 1))) / step;
+    }
+
+    static constexpr size_t class_size(size_t size_class) noexcept {
+        if (size_class < 8) {
+            return (size_class + 1) * ALIGNMENT_;
+        }
+        const size_t bits = (size_class - 8) / 4 + 8;
+        return (size_t{1} << (bits - 1)) + ((size_class - 8) % 4 + 1) * (size_t{1} << (bits - 3));
+    }
+
+    struct Block {
+        Block* next;
+    };
+
+    struct Heap;
+
+    // Header at the start of every page. The remote list has a cache line to itself, away from the fields
+    // the owner writes on every allocation.
+    struct alignas(CACHE_LINE_SIZE_) Page {
+        std::atomic<Block*> remote_free{nullptr};
+        alignas(CACHE_LINE_SIZE_) Heap* heap = nullptr;
+        Page* next = nullptr;  // Next page of the same class in the heap
+        Block* local_free = nullptr;
+        uint32_t block_size = 0;
+        uint32_t capacity = 0;  // Blocks in the page
+        uint32_t carved = 0;    // Blocks handed out at least once; the rest is untouched memory
+        bool large = false;     // A single block above MAX_SMALL
+
+        std::byte* data() noexcept { return reinterpret_cast<std::byte*>(this + 1); }
+    };
+
+    struct Heap {
+        Heap* next = nullptr;  // Registry link, immutable once published
+        std::atomic<bool> attached{true};
+        std::atomic<int> references{2};  // The allocator and the owning thread's lease
+        // Owner only
+        Page* pages[CLASSES_] = {};
+        Page* current[CLASSES_] = {};
+    };
+
+    // A thread's heaps, detached when the thread exits
+    struct Leases {
+        struct Lease {
+            uint64_t allocator;
+            Heap* heap;
+        };
+        std::vector<Lease> leases;
+
+        ~Leases() {
+            for (const Lease& lease : leases) {
+                lease.heap->attached.store(false, std::memory_order_release);
+                drop(lease.heap);
+            }
+        }
+    };
+
+    // No member initializers, the thread_local below is value-initialized: no allocator has id 0
+    struct HeapCache {
+        uint64_t allocator;
+        Heap* heap;
+    };
+
+    static Page* page_of(void* pointer) noexcept {
+        return reinterpret_cast<Page*>(reinterpret_cast<uintptr_t>(pointer) & ~(uintptr_t{PAGE_BYTES} - 1));
+    }
+
+    static void free_page(Page* page) noexcept {
+        page->~Page();
+        ::operator delete(page, std::align_val_t{PAGE_BYTES});
+    }
+
+    static void drop(Heap* heap) noexcept {
+        if (heap->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete heap;
+        }
+    }
+
+    void* allocate_large(size_t bytes) {
+        void* memory = ::operator new(sizeof(Page) + bytes, std::align_val_t{PAGE_BYTES});
+        Page* page = ::new (memory) Page;
+        page->large = true;
+        return page->data();
+    }
+
+    // Current page empty: refill it from its remote frees, or move to another page of the class, or add one
+    void* allocate_slow(Heap& heap, size_t size_class) {
+        if (Page* page = heap.current[size_class]; page != nullptr) {
+            if (void* block = take(*page)) {
+                return block;
+            }
+        }
+        for (Page* page = heap.pages[size_class]; page != nullptr; page = page->next) {
+            if (void* block = take(*page)) {
+                heap.current[size_class] = page;
+                return block;
+            }
+        }
+        void* memory = ::operator new(PAGE_BYTES, std::align_val_t{PAGE_BYTES});
+        Page* page = ::new (memory) Page;
+        page->heap = &heap;
+        page->block_size = static_cast<uint32_t>(class_size(size_class));
+        page->capacity = static_cast<uint32_t>((PAGE_BYTES - sizeof(Page)) / page->block_size);
+        page->next = heap.pages[size_class];
+        heap.pages[size_class] = page;
+        heap.current[size_class] = page;
+        return take(*page);
+    }
+
+    // Owner only. A block of the page, or nullptr if it has none free.
+    static void* take(Page& page) noexcept {
+        if (page.local_free == nullptr) {
+            // Acquire pairs with the remote frees' release
+            page.local_free = page.remote_free.exchange(nullptr, std::memory_order_acquire);
+        }
+        if (Block* block = page.local_free; block != nullptr) {
+            page.local_free = block->next;
+            return block;
+        }
+        if (page.carved < page.capacity) {
+            return page.data() + size_t{page.carved++} * page.block_size;
+        }
+        return nullptr;
+    }
+
+    // The calling thread's heap if it has one already, else nullptr
+    Heap* cached_heap() const noexcept {
+        const HeapCache& cache = heap_cache_;
+        return cache.allocator == id_ ? cache.heap : nullptr;
+    }
+
+    Heap& local_heap() {
+        if (Heap* heap = cached_heap()) {
+            return *heap;
+        }
+        return attach_heap();
+    }
+
+    // Slow path: the thread's lease, else a heap an exited thread left behind, else a new heap
+    Heap& attach_heap() {
+        static thread_local Leases leases;
+        for (const auto& lease : leases.leases) {
+            if (lease.allocator == id_) {
+                heap_cache_ = HeapCache{id_, lease.heap};
+                return *lease.heap;
+            }
+        }
+        Heap* heap = nullptr;
+        for (Heap* candidate = heaps_.load(std::memory_order_acquire); candidate != nullptr;
+             candidate = candidate->next) {
+            bool attached = false;
+            if (!candidate->attached.load(std::memory_order_relaxed) &&
+                candidate->attached.compare_exchange_strong(attached, true, std::memory_order_acquire)) {
+                candidate->references.fetch_add(1, std::memory_order_relaxed);
+                heap = candidate;
+                break;
+            }
+        }
+        if (heap == nullptr) {
+            heap = new Heap;
+            heap->next = heaps_.load(std::memory_order_relaxed);
+            while (!heaps_.compare_exchange_weak(heap->next, heap, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+            }
+            heap_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+        leases.leases.push_back({id_, heap});
+        heap_cache_ = HeapCache{id_, heap};
+        return *heap;
+    }
+
+    inline static std::atomic<uint64_t> next_id_{1};
+    inline static thread_local HeapCache heap_cache_{};
+
+    // Ids rather than addresses tell allocators apart, so that a new allocator at a dead one's address does not
+    // inherit its heaps
+    const uint64_t id_ = next_id_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic<Heap*> heaps_{nullptr};
+    std::atomic<size_t> heap_count_{0};
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace lockfreekit {
+
+// Scalable non-zero indicator (Ellen, Lev, Luchangco, Moir, PODC 2007): tells whether any thread is "inside"
+// (waiting, reading, holding a reference) without a single counter every arrival has to hit.
+//
+// Threads arrive and depart at the leaves of a binary tree of counters. A node only passes an arrival up to its
+// parent when its own count goes from zero to non-zero, and a departure when it drops back to zero, so
+// concurrent arrivals at busy leaves never reach the root. query() reads one indicator bit at the root, which
+// changes only when the whole tree goes from empty to non-empty or back.
+//
+// A departure must go to the leaf its arrival went to, hence the Ticket. All operations are sequentially
+// consistent, so query() can sit on either side of a Dekker-style handshake (a waiter arrives then re-checks
+// the condition; a waker changes the condition then queries).
+class Snzi {
+   public:
+    using Ticket = uint32_t;  // The leaf an arrival went to
+
+    // `leaves` is rounded up to a power of two; 0 means one per hardware thread
+    explicit Snzi(size_t leaves = 0)
+        : leaf_count_(std::bit_ceil(leaves > 0 ? leaves : std::max<size_t>(std::thread::hardware_concurrency(), 1))),
+          nodes_(std::make_unique<Node[]>(2 * leaf_count_ - 1)) {}
+
+    [[nodiscard]] Ticket arrive() noexcept {
+        const auto leaf = static_cast<Ticket>(leaf_count_ - 1 + (thread_stripe() & (leaf_count_ - 1)));
+        arrive_at(leaf);
+        return leaf;
+    }
+
+    void depart(Ticket ticket) noexcept { depart_at(ticket); }
+
+    // True while some arrival has not departed yet
+    [[nodiscard]] bool query() const noexcept { return (indicator_.load() & INDICATOR_BIT_) != 0; }
+
+    [[nodiscard]] size_t leaves() const noexcept { return leaf_count_; }
+
+    // Delete copy/move constructors and assignment operators
+    Snzi(const Snzi&) = delete;
+    Snzi& operator=(const Snzi&) = delete;
+    Snzi(Snzi&&) = delete;
+    Snzi& operator=(Snzi&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+    static constexpr uint32_t ROOT_ = 0;
+
+    // The indicator is a bit plus a write counter; the counter emulates the LL/SC the paper's root departure
+    // needs (an SC fails if anyone wrote the indicator since the LL).
+    static constexpr uint64_t INDICATOR_BIT_ = 1;
+    static constexpr uint64_t INDICATOR_WRITE_ = 2;
+
+    // Root word: count (32 bits) | announce (1 bit) | version (31 bits)
+    static constexpr int ROOT_ANNOUNCE_SHIFT_ = 32;
+    static constexpr int ROOT_VERSION_SHIFT_ = 33;
+    static constexpr uint64_t ROOT_COUNT_MASK_ = 0xffffffffULL;
+
+    // Inner/leaf word: count in halves (32 bits) | version (32 bits). A count of one half means "arriving":
+    // the node's first arrival is being passed up to its parent.
+    static constexpr uint64_t HALF_ = 1;
+    static constexpr uint64_t ONE_ = 2;
+
+    struct alignas(CACHE_LINE_SIZE_) Node {
+        std::atomic<uint64_t> word{0};
+    };
+
+    static uint64_t root_word(uint64_t count, bool announce, uint64_t version) noexcept {
+        return count | (announce ? uint64_t{1} << ROOT_ANNOUNCE_SHIFT_ : 0) | (version << ROOT_VERSION_SHIFT_);
+    }
+    static uint64_t root_count(uint64_t word) noexcept { return word & ROOT_COUNT_MASK_; }
+    static bool root_announce(uint64_t word) noexcept { return ((word >> ROOT_ANNOUNCE_SHIFT_) & 1) != 0; }
+    static uint64_t root_version(uint64_t word) noexcept { return word >> ROOT_VERSION_SHIFT_; }
+
+    static uint64_t node_word(uint64_t halves, uint64_t version) noexcept { return halves | (version << 32); }
+    static uint64_t node_halves(uint64_t word) noexcept { return word & 0xffffffffULL; }
+    static uint64_t node_version(uint64_t word) noexcept { return word >> 32; }
+
+    static uint32_t parent(uint32_t node) noexcept { return (node - 1) / 2; }
+
+    void arrive_at(uint32_t node) noexcept {
+        if (node == ROOT_) {
+            arrive_root();
+            return;
+        }
+        std::atomic<uint64_t>& word = nodes_[node].word;
+        bool done = false;
+        int undo = 0;  // Arrivals at the parent made on behalf of a half count someone else resolved
+        while (!done) {
+            uint64_t x = word.load();
+            if (node_halves(x) >= ONE_) {
+                done = word.compare_exchange_strong(x, node_word(node_halves(x) + ONE_, node_version(x)));
+            }
+            if (node_halves(x) == 0) {
+                const uint64_t arriving = node_word(HALF_, node_version(x) + 1);
+                if (word.compare_exchange_strong(x, arriving)) {
+                    done = true;
+                    x = arriving;
+                }
+            }
+            if (node_halves(x) == HALF_) {
+                // Whoever finds the node arriving helps: arrive at the parent, then try to complete the count
+                arrive_at(parent(node));
+                if (!word.compare_exchange_strong(x, node_word(ONE_, node_version(x)))) {
+                    ++undo;
+                }
+            }
+        }
+        for (; undo > 0; --undo) {
+            depart_at(parent(node));
+        }
+    }
+
+    void depart_at(uint32_t node) noexcept {
+        if (node == ROOT_) {
+            depart_root();
+            return;
+        }
+        std::atomic<uint64_t>& word = nodes_[node].word;
+        for (;;) {
+            uint64_t x = word.load();
+            if (word.compare_exchange_weak(x, node_word(node_halves(x) - ONE_, node_version(x)))) {
+                if (node_halves(x) == ONE_) {
+                    depart_at(parent(node));
+                }
+                return;
+            }
+        }
+    }
+
+    void arrive_root() noexcept {
+        std::atomic<uint64_t>& word = nodes_[ROOT_].word;
+        uint64_t x = word.load();
+        uint64_t next = 0;
+        do {
+            next = root_count(x) == 0 ? root_word(1, true, root_version(x) + 1)
+                                      : root_word(root_count(x) + 1, root_announce(x), root_version(x));
+        } while (!word.compare_exchange_weak(x, next));
+        if (root_announce(next)) {
+            write_indicator(true);
+            (void)word.compare_exchange_strong(next, root_word(root_count(next), false, root_version(next)));
+        }
+    }
+
+    void depart_root() noexcept {
+        std::atomic<uint64_t>& word = nodes_[ROOT_].word;
+        uint64_t x = word.load();
+        while (!word.compare_exchange_weak(x, root_word(root_count(x) - 1, false, root_version(x)))) {
+        }
+        if (root_count(x) >= 2) {
+            return;
+        }
+        // We took the count to zero: clear the indicator, unless an arrival started a new version meanwhile
+        for (;;) {
+            uint64_t indicator = indicator_.load();  // LL
+            if (root_version(word.load()) != root_version(x)) {
+                return;
+            }
+            if (indicator_.compare_exchange_strong(indicator, (indicator & ~INDICATOR_BIT_) + INDICATOR_WRITE_)) {
+                return;  // SC
+            }
+        }
+    }
+
+    void write_indicator(bool value) noexcept {
+        uint64_t indicator = indicator_.load();
+        while (!indicator_.compare_exchange_weak(
+            indicator, ((indicator & ~INDICATOR_BIT_) + INDICATOR_WRITE_) | (value ? INDICATOR_BIT_ : 0))) {
+        }
+    }
+
+    // Sequential, so that the first threads land on distinct leaves
+    static size_t thread_stripe() noexcept {
+        static std::atomic<size_t> next{0};
+        static thread_local const size_t stripe = next.fetch_add(1, std::memory_order_relaxed);
+        return stripe;
+    }
+
+    const size_t leaf_count_;
+    std::unique_ptr<Node[]> nodes_;  // Binary heap layout, the root at 0 and the leaves last
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<uint64_t> indicator_{0};
+    char pad0[CACHE_LINE_SIZE_ - sizeof(indicator_)]{};
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <thread>
+
+namespace lockfreekit {
+
+// Tells the core we are busy-waiting (frees pipeline resources for the sibling hyperthread).
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Spin-then-yield backoff for wait loops: spins with cpu_relax() for a while, then starts yielding so
+// an oversubscribed machine can still run whoever we are waiting for.
+class SpinWait {
+   public:
+    void wait() noexcept {
+        if (spins_ < SPINS_BEFORE_YIELD_) {
+            ++spins_;
+            cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    void reset() noexcept { spins_ = 0; }
+
+   private:
+    static constexpr uint32_t SPINS_BEFORE_YIELD_ = 64;
+
+    uint32_t spins_ = 0;
+};
+
+}  // namespace lockfreekit
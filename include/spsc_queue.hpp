@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "mpmc_queue.hpp"
+
+namespace lockfreekit {
+
+// Bounded single-producer single-consumer ring (Lamport's queue with cached indices).
+//
+// Each side keeps a private copy of the other side's index and only reloads it when that copy says the ring is
+// full (producer) or empty (consumer), so in steady state an element costs one release store and no CAS. The
+// ring has one spare slot to tell full from empty.
+template <typename T>
+requires QueueValue<T>
+class SPSCQueue {
+   public:
+    explicit SPSCQueue(size_t capacity) : capacity_(capacity), buffer_(capacity + 1) {
+        if (capacity_ < 1) {
+            throw std::invalid_argument("Queue capacity must be > 0");
+        }
+    }
+
+    // Producer only. Returns false when full.
+    [[nodiscard]] bool enqueue(const T& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t next = increment(tail);
+        if (next == head_cache_) {
+            // Acquire: the consumer has moved the value out of the slot before releasing it
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (next == head_cache_) {
+                return false;  // Full
+            }
+        }
+        buffer_[tail] = value;
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only.
+    [[nodiscard]] std::optional<T> dequeue() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            // Acquire: pairs with the producer's release store, the value is visible
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return std::nullopt;  // Empty
+            }
+        }
+        T value = std::move(buffer_[head]);
+        head_.store(increment(head), std::memory_order_release);
+        return value;
+    }
+
+    // Exact from the consumer thread; from any other thread only a hint
+    [[nodiscard]] bool empty() const noexcept {
+        return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t approx_size() const noexcept {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : tail + buffer_.size() - head;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+    // Delete copy/move constructors and assignment operators
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+    SPSCQueue(SPSCQueue&&) = delete;
+    SPSCQueue& operator=(SPSCQueue&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+
+    size_t increment(size_t pos) const noexcept { return pos + 1 == buffer_.size() ? 0 : pos + 1; }
+
+    const size_t capacity_;
+    std::vector<T> buffer_;
+
+    // Producer's line: its index and its copy of the consumer's
+    alignas(CACHE_LINE_SIZE_) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0;
+    // Consumer's line
+    alignas(CACHE_LINE_SIZE_) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0;
+    char pad0[CACHE_LINE_SIZE_ - sizeof(head_) - sizeof(tail_cache_)]{};
+};
+
+}  // namespace lockfreekit
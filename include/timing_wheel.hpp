@@ -0,0 +1,284 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+
+#include "intrusive_mpsc_queue.hpp"
+#include "mpmc_queue.hpp"
+
+namespace lockfreekit {
+
+// Single-threaded hierarchical timing wheel over nodes that live elsewhere (an array, a pool), addressed by
+// 32-bit index. A node needs a `uint64_t tick` (its deadline) and a `uint32_t next` link; `node_at(index)`
+// returns a reference to it.
+//
+// LEVELS slots rings of 64, level L counting in units of 64^L ticks; deadlines further out than 64^LEVELS ticks
+// wait in an overflow list. A node is filed at the lowest level whose current rotation contains its deadline,
+// and moves down a level each time time reaches its slot (cascading), until it expires at level 0. advance()
+// jumps from one occupied slot to the next using per-level occupancy bitmaps, so idle time costs nothing.
+class HierarchicalWheel {
+   public:
+    static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+    static constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+    HierarchicalWheel() noexcept {
+        for (auto& level : slots_) {
+            std::fill(std::begin(level), std::end(level), NIL);
+        }
+    }
+
+    [[nodiscard]] uint64_t current_tick() const noexcept { return current_tick_; }
+
+    // Files node `index`; returns false (and leaves it alone) if its deadline is not in the future
+    template <typename NodeAt>
+    bool place(uint32_t index, NodeAt&& node_at) noexcept {
+        auto& node = node_at(index);
+        if (node.tick <= current_tick_) {
+            return false;
+        }
+        const uint64_t diff = node.tick ^ current_tick_;
+        for (int level = 0; level < LEVELS_; ++level) {
+            if ((diff >> (SLOT_BITS_ * (level + 1))) == 0) {
+                const auto slot = static_cast<size_t>((node.tick >> (SLOT_BITS_ * level)) & (SLOTS_ - 1));
+                node.next = slots_[level][slot];
+                slots_[level][slot] = index;
+                occupied_[level] |= uint64_t{1} << slot;
+                return true;
+            }
+        }
+        node.next = overflow_;
+        overflow_ = index;
+        return true;
+    }
+
+    // The earliest tick at which the wheel has something to do: expire a level 0 slot, cascade a higher level
+    // slot, or re-file the overflow list. Never later than the earliest deadline; NEVER if the wheel is empty.
+    [[nodiscard]] uint64_t next_event_tick() const noexcept {
+        uint64_t best = NEVER;
+        for (int level = 0; level < LEVELS_; ++level) {
+            const int shift = SLOT_BITS_ * level;
+            const auto digit = static_cast<int>((current_tick_ >> shift) & (SLOTS_ - 1));
+            // Slots at or before the current digit are empty: they were processed when time passed them
+            const uint64_t ahead = occupied_[level] & ~((uint64_t{2} << digit) - 1);
+            if (ahead == 0) {
+                continue;
+            }
+            const uint64_t rotation_start = current_tick_ & ~((uint64_t{1} << (shift + SLOT_BITS_)) - 1);
+            best = std::min(best, rotation_start + (static_cast<uint64_t>(std::countr_zero(ahead)) << shift));
+        }
+        if (overflow_ != NIL) {
+            best = std::min(best, (current_tick_ | (SPAN_ - 1)) + 1);
+        }
+        return best;
+    }
+
+    // Moves the wheel to `now`. Every node of a slot that time reached is detached and handed to refile(index),
+    // which normally place()s it again: nodes that cannot be placed anymore are due.
+    template <typename NodeAt, typename Refile>
+    void advance(uint64_t now, NodeAt&& node_at, Refile&& refile) {
+        while (current_tick_ < now) {
+            const uint64_t next = next_event_tick();
+            if (next > now) {
+                current_tick_ = now;  // Nothing happens in between
+                return;
+            }
+            current_tick_ = next;
+            if ((current_tick_ & (SPAN_ - 1)) == 0 && overflow_ != NIL) {
+                const uint32_t list = overflow_;
+                overflow_ = NIL;
+                refile_list(list, node_at, refile);
+            }
+            for (int level = LEVELS_ - 1; level >= 0; --level) {
+                const int shift = SLOT_BITS_ * level;
+                if ((current_tick_ & ((uint64_t{1} << shift) - 1)) != 0) {
+                    continue;  // Not at the start of a slot of this level
+                }
+                const auto slot = static_cast<size_t>((current_tick_ >> shift) & (SLOTS_ - 1));
+                if ((occupied_[level] & (uint64_t{1} << slot)) != 0) {
+                    const uint32_t list = slots_[level][slot];
+                    slots_[level][slot] = NIL;
+                    occupied_[level] &= ~(uint64_t{1} << slot);
+                    refile_list(list, node_at, refile);
+                }
+            }
+        }
+    }
+
+   private:
+    static constexpr int SLOT_BITS_ = 6;
+    static constexpr uint64_t SLOTS_ = uint64_t{1} << SLOT_BITS_;
+    static constexpr int LEVELS_ = 4;
+    static constexpr uint64_t SPAN_ = uint64_t{1} << (SLOT_BITS_ * LEVELS_);
+
+    template <typename NodeAt, typename Refile>
+    static void refile_list(uint32_t index, NodeAt& node_at, Refile& refile) {
+        while (index != NIL) {
+            const uint32_t next = node_at(index).next;
+            refile(index);
+            index = next;
+        }
+    }
+
+    uint64_t current_tick_ = 0;
+    uint32_t slots_[LEVELS_][SLOTS_];  // Heads of the slot lists
+    uint64_t occupied_[LEVELS_] = {};
+    uint32_t overflow_ = NIL;
+};
+
+// Timing wheel for large numbers of mostly cancelled timers (connection timeouts).
+//
+// schedule_at() and cancel() are O(1) and lock-free from any thread; one owner thread calls advance() to
+// process ticks in batches. Timers are intrusive nodes from a fixed pool, so scheduling allocates nothing:
+// - schedule takes a node off the pool's free ring (an MPMCQueue of indices), fills it in and pushes it into an
+//   IntrusiveMPSCQueue inbox, one XCHG;
+// - cancel is one CAS on the node's state; the owner reclaims the node lazily, the next time it refiles it:
+//   when the node comes out of the inbox, or when time reaches the slot (or overflow turn) holding it. For a
+//   timer in a higher-level slot that is its cascade, well before the deadline; a timer cancelled in the
+//   overflow list or in a level-0 slot keeps its pool node until time gets there;
+// - advance drains the inbox into a HierarchicalWheel and fires what is due.
+//
+// A node's state word carries a generation that changes every time the node returns to the pool, so a stale
+// Handle can never cancel somebody else's timer.
+template <typename Payload>
+requires QueueValue<Payload>
+class TimingWheel {
+   public:
+    struct Handle {
+        uint32_t index = 0;
+        uint64_t generation = 0;
+    };
+
+    // `capacity` is the number of timers that can be pending (or cancelled but not yet reclaimed) at once
+    explicit TimingWheel(size_t capacity)
+        : capacity_(capacity), free_(capacity), timers_(std::make_unique<Timer[]>(capacity)) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            timers_[i].index = static_cast<uint32_t>(i);
+            (void)free_.enqueue(static_cast<uint32_t>(i));
+        }
+    }
+
+    // Any thread. Returns nullopt if the pool is exhausted. A deadline that is not in the future fires on the
+    // next advance().
+    [[nodiscard]] std::optional<Handle> schedule_at(uint64_t tick, const Payload& payload) {
+        const std::optional<uint32_t> index = free_.dequeue();
+        if (!index) {
+            return std::nullopt;
+        }
+        Timer& timer = timers_[*index];
+        const uint64_t generation = timer.state.load(std::memory_order_relaxed) >> STATUS_BITS_;
+        timer.tick = tick;
+        timer.payload = payload;
+        timer.state.store(generation << STATUS_BITS_ | SCHEDULED_, std::memory_order_relaxed);
+        inbox_.push(&timer);  // Publishes the fields above to the owner
+        return Handle{*index, generation};
+    }
+
+    [[nodiscard]] std::optional<Handle> schedule_in(uint64_t ticks, const Payload& payload) {
+        return schedule_at(current_tick() + ticks, payload);
+    }
+
+    // Any thread. Returns true if the timer was pending and now will not fire.
+    bool cancel(const Handle& handle) noexcept {
+        if (handle.index >= capacity_) {
+            return false;
+        }
+        uint64_t expected = handle.generation << STATUS_BITS_ | SCHEDULED_;
+        return timers_[handle.index].state.compare_exchange_strong(
+            expected, handle.generation << STATUS_BITS_ | CANCELLED_, std::memory_order_relaxed);
+    }
+
+    // Owner only. Moves time to `now` and calls on_expire(payload) for every timer due by then, in no particular
+    // order within a tick. Returns the number of timers fired.
+    template <typename OnExpire>
+    size_t advance(uint64_t now, OnExpire&& on_expire) {
+        size_t fired = 0;
+        auto node_at = [this](uint32_t index) -> Timer& { return timers_[index]; };
+        auto expire = [&](uint32_t index) {
+            Timer& timer = timers_[index];
+            uint64_t state = timer.state.load(std::memory_order_relaxed);
+            // The CAS races with cancel(): exactly one of them wins
+            if ((state & STATUS_MASK_) == SCHEDULED_ &&
+                timer.state.compare_exchange_strong(state, (state & ~STATUS_MASK_) | FIRED_,
+                                                    std::memory_order_relaxed)) {
+                on_expire(timer.payload);
+                ++fired;
+            }
+            release(timer);
+        };
+        auto refile = [&](uint32_t index) {
+            Timer& timer = timers_[index];
+            if ((timer.state.load(std::memory_order_relaxed) & STATUS_MASK_) == CANCELLED_) {
+                release(timer);
+            } else if (!wheel_.place(index, node_at)) {
+                expire(index);
+            }
+        };
+
+        while (Timer* timer = inbox_.pop()) {
+            refile(timer->index);
+        }
+        wheel_.advance(now, node_at, refile);
+        current_tick_.store(wheel_.current_tick(), std::memory_order_relaxed);
+        return fired;
+    }
+
+    // Owner only. The tick the owner may sleep until without missing a deadline already in the wheel (timers
+    // scheduled meanwhile may be earlier); HierarchicalWheel::NEVER if none is pending.
+    [[nodiscard]] uint64_t next_event_tick() const noexcept { return wheel_.next_event_tick(); }
+
+    // The tick the owner last advanced to
+    [[nodiscard]] uint64_t current_tick() const noexcept { return current_tick_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+    // Delete copy/move constructors and assignment operators
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+    TimingWheel(TimingWheel&&) = delete;
+    TimingWheel& operator=(TimingWheel&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+
+    // Low bits of the state word; the rest is the generation
+    static constexpr int STATUS_BITS_ = 2;
+    static constexpr uint64_t STATUS_MASK_ = (uint64_t{1} << STATUS_BITS_) - 1;
+    static constexpr uint64_t FREE_ = 0;
+    static constexpr uint64_t SCHEDULED_ = 1;
+    static constexpr uint64_t CANCELLED_ = 2;
+    static constexpr uint64_t FIRED_ = 3;
+
+    struct Timer : IntrusiveMPSCNode {
+        std::atomic<uint64_t> state{FREE_};
+        uint64_t tick = 0;
+        uint32_t next = HierarchicalWheel::NIL;  // Wheel link, owner only
+        uint32_t index = 0;
+        Payload payload{};
+    };
+
+    // Owner only. Bumps the generation and returns the node to the pool.
+    void release(Timer& timer) {
+        const uint64_t generation = timer.state.load(std::memory_order_relaxed) >> STATUS_BITS_;
+        timer.payload = Payload{};
+        timer.state.store((generation + 1) << STATUS_BITS_ | FREE_, std::memory_order_relaxed);
+        (void)free_.enqueue(timer.index);  // Release: the next owner of the node sees it reset
+    }
+
+    const size_t capacity_;
+    MPMCQueue<uint32_t> free_;
+    std::unique_ptr<Timer[]> timers_;
+    IntrusiveMPSCQueue<Timer> inbox_;
+
+    // Owner only
+    HierarchicalWheel wheel_;
+    alignas(CACHE_LINE_SIZE_) std::atomic<uint64_t> current_tick_{0};
+    char pad0[CACHE_LINE_SIZE_ - sizeof(current_tick_)]{};
+};
+
+}  // namespace lockfreekit
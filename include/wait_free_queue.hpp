@@ -0,0 +1,491 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace lockfreekit {
+
+// Unbounded wait-free MPMC queue after Yang & Mellor-Crummey ("A Wait-free Queue as Fast as Fetch-and-Add").
+//
+// The queue emulates an infinite array of cells with a linked list of fixed-size segments. Both operations claim
+// a cell with fetch_add and try to finish with a single CAS (fast path). After MAX_PATIENCE_ failed attempts an
+// operation publishes a request in its handle and switches to the slow path; dequeuers help pending requests of
+// their peers in round-robin order, which bounds the number of steps any operation can take.
+//
+// Elements are non-null pointers owned by the caller. Every thread must use its own Handle from register_thread().
+template <typename T, size_t segment_size = 1022>
+requires(segment_size > 0)
+class WaitFreeQueue {
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+
+    struct EnqRequest {
+        std::atomic<int64_t> id{0};  // > 0: pending since cell `id`, < 0: completed in cell `-id`
+        std::atomic<T*> value{nullptr};
+    };
+
+    struct DeqRequest {
+        std::atomic<int64_t> id{0};    // cell where the fast path gave up
+        std::atomic<int64_t> idx{-1};  // >= id: pending (candidate cell), < 0: completed in cell `-idx`
+    };
+
+    struct alignas(CACHE_LINE_SIZE_) Cell {
+        std::atomic<T*> value{nullptr};
+        std::atomic<EnqRequest*> enq{nullptr};
+        std::atomic<DeqRequest*> deq{nullptr};
+    };
+
+    struct Segment {
+        alignas(CACHE_LINE_SIZE_) std::atomic<Segment*> next{nullptr};
+        alignas(CACHE_LINE_SIZE_) int64_t id = 0;
+        Cell cells[segment_size];
+    };
+
+   public:
+    class Handle {
+       public:
+        Handle() = default;
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+       private:
+        friend class WaitFreeQueue;
+
+        Handle* next_ = nullptr;  // Peers form a ring used for round-robin helping
+
+        // Id of the oldest segment this handle may touch while an operation is in flight
+        std::atomic<int64_t> hazard_segment_id_{NO_HAZARD_};
+        std::atomic<Segment*> enq_segment_{nullptr};
+        int64_t enq_segment_id_ = 0;
+        std::atomic<Segment*> deq_segment_{nullptr};
+        int64_t deq_segment_id_ = 0;
+
+        alignas(CACHE_LINE_SIZE_) EnqRequest enq_request_;
+        alignas(CACHE_LINE_SIZE_) DeqRequest deq_request_;
+
+        alignas(CACHE_LINE_SIZE_) Handle* enq_peer_ = nullptr;
+        int64_t enq_peer_request_id_ = 0;
+        Handle* deq_peer_ = nullptr;
+        Segment* spare_ = nullptr;
+        std::vector<Handle*> cleanup_scratch_;
+    };
+
+    explicit WaitFreeQueue(size_t max_threads)
+        : max_threads_(max_threads), handles_(max_threads > 0 ? std::make_unique<Handle[]>(max_threads) : nullptr) {
+        if (max_threads_ < 1) {
+            throw std::invalid_argument("Queue max_threads must be > 0");
+        }
+        head_segment_ = new Segment();
+        for (size_t i = 0; i < max_threads_; ++i) {
+            Handle& handle = handles_[i];
+            handle.next_ = &handles_[(i + 1) % max_threads_];
+            handle.enq_peer_ = handle.next_;
+            handle.deq_peer_ = handle.next_;
+            handle.enq_segment_.store(head_segment_, std::memory_order_relaxed);
+            handle.deq_segment_.store(head_segment_, std::memory_order_relaxed);
+        }
+    }
+
+    ~WaitFreeQueue() {
+        for (Segment* segment = head_segment_; segment != nullptr;) {
+            Segment* next = segment->next.load(std::memory_order_relaxed);
+            delete segment;
+            segment = next;
+        }
+        for (size_t i = 0; i < max_threads_; ++i) {
+            delete handles_[i].spare_;
+        }
+    }
+
+    // Hands out one of the `max_threads` handles. A handle must not be shared between threads.
+    [[nodiscard]] Handle& register_thread() {
+        const size_t index = registered_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= max_threads_) {
+            throw std::length_error("WaitFreeQueue: more threads registered than max_threads");
+        }
+        Handle& handle = handles_[index];
+        handle.spare_ = new Segment();
+        handle.cleanup_scratch_.reserve(max_threads_);
+        return handle;
+    }
+
+    // `value` must not be null.
+    void enqueue(Handle& th, T* value) {
+        th.hazard_segment_id_.store(th.enq_segment_id_);
+        int64_t id = 0;
+        int patience = MAX_PATIENCE_;
+        while (!enqueue_fast(th, value, id) && patience-- > 0) {
+        }
+        if (patience < 0) {
+            enqueue_slow(th, value, id);
+        }
+        th.enq_segment_id_ = th.enq_segment_.load()->id;
+        th.hazard_segment_id_.store(NO_HAZARD_, std::memory_order_release);
+    }
+
+    // Returns nullptr if the queue was observed empty.
+    [[nodiscard]] T* dequeue(Handle& th) {
+        th.hazard_segment_id_.store(th.deq_segment_id_);
+        int64_t id = 0;
+        int patience = MAX_PATIENCE_;
+        T* value;
+        do {
+            value = dequeue_fast(th, id);
+        } while (value == top_value() && patience-- > 0);
+        if (value == top_value()) {
+            value = dequeue_slow(th, id);
+        }
+        // Only successful dequeuers help, so that helping cannot starve on an empty queue
+        if (value != nullptr) {
+            help_dequeue(th, *th.deq_peer_);
+            th.deq_peer_ = th.deq_peer_->next_;
+        }
+        th.deq_segment_id_ = th.deq_segment_.load()->id;
+        th.hazard_segment_id_.store(NO_HAZARD_, std::memory_order_release);
+        // The spare segment was linked in, so the list grew: a good time to reclaim the old end
+        if (th.spare_ == nullptr) {
+            cleanup(th);
+            th.spare_ = new Segment();
+        }
+        return value;
+    }
+
+    [[nodiscard]] size_t approx_size() const noexcept {
+        const int64_t size = enq_index_.load(std::memory_order_relaxed) - deq_index_.load(std::memory_order_relaxed);
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+
+    // Delete copy/move constructors and assignment operators
+    WaitFreeQueue(const WaitFreeQueue&) = delete;
+    WaitFreeQueue& operator=(const WaitFreeQueue&) = delete;
+    WaitFreeQueue(WaitFreeQueue&&) = delete;
+    WaitFreeQueue& operator=(WaitFreeQueue&&) = delete;
+
+   private:
+    static constexpr int MAX_PATIENCE_ = 10;
+    static constexpr int MAX_SPIN_ = 100;
+    static constexpr int64_t NO_HAZARD_ = std::numeric_limits<int64_t>::max();
+    static constexpr int64_t SEGMENT_SIZE_ = static_cast<int64_t>(segment_size);
+
+    // Sentinels: nullptr is "never written" (BOT in the paper), all-ones is "unusable" (TOP)
+    static T* top_value() noexcept { return reinterpret_cast<T*>(~uintptr_t{0}); }
+    static EnqRequest* top_enq() noexcept { return reinterpret_cast<EnqRequest*>(~uintptr_t{0}); }
+    static DeqRequest* top_deq() noexcept { return reinterpret_cast<DeqRequest*>(~uintptr_t{0}); }
+
+    // Walks forward from `segment` to the cell with index `i`, appending segments (the handle's spare first) as
+    // needed. Segments are never walked backwards, so `segment` must not be past the one holding `i`.
+    Cell& find_cell(Segment*& segment, int64_t i, Handle& th) {
+        Segment* curr = segment;
+        for (int64_t j = curr->id; j < i / SEGMENT_SIZE_; ++j) {
+            Segment* next = curr->next.load(std::memory_order_acquire);
+            if (next == nullptr) {
+                Segment* spare = th.spare_;
+                if (spare == nullptr) {
+                    spare = new Segment();
+                    th.spare_ = spare;
+                }
+                spare->id = j + 1;
+                if (curr->next.compare_exchange_strong(next, spare, std::memory_order_acq_rel)) {
+                    next = spare;
+                    th.spare_ = nullptr;
+                }
+            }
+            curr = next;
+        }
+        segment = curr;
+        return curr->cells[i % SEGMENT_SIZE_];
+    }
+
+    Cell& find_cell(std::atomic<Segment*>& cursor, int64_t i, Handle& th) {
+        Segment* segment = cursor.load();
+        Cell& cell = find_cell(segment, i, th);
+        cursor.store(segment);
+        return cell;
+    }
+
+    static T* spin(const std::atomic<T*>& value) noexcept {
+        T* v = value.load(std::memory_order_acquire);
+        for (int patience = MAX_SPIN_; v == nullptr && patience > 0; --patience) {
+            v = value.load(std::memory_order_acquire);
+        }
+        return v;
+    }
+
+    bool enqueue_fast(Handle& th, T* value, int64_t& id) {
+        const int64_t i = enq_index_.fetch_add(1);
+        Cell& cell = find_cell(th.enq_segment_, i, th);
+        T* expected = nullptr;
+        if (cell.value.compare_exchange_strong(expected, value)) {
+            return true;
+        }
+        id = i;  // A dequeuer got to the cell first and marked it unusable
+        return false;
+    }
+
+    void enqueue_slow(Handle& th, T* value, int64_t id) {
+        EnqRequest& request = th.enq_request_;
+        request.value.store(value, std::memory_order_release);
+        request.id.store(id, std::memory_order_release);
+
+        // Keep claiming fresh cells ourselves until either we or a helping dequeuer reserve one for the request
+        Segment* tail = th.enq_segment_.load();
+        int64_t i;
+        do {
+            i = enq_index_.fetch_add(1);
+            Cell& cell = find_cell(tail, i, th);
+            EnqRequest* expected = nullptr;
+            // The store to cell.enq and the load of cell.value must be seq_cst: help_enqueue() does the mirror
+            // image (store cell.value, load cell.enq) and exactly one side must observe the other.
+            if (cell.enq.compare_exchange_strong(expected, &request) && cell.value.load() != top_value()) {
+                request.id.compare_exchange_strong(id, -i);
+                break;
+            }
+        } while (request.id.load() > 0);
+
+        id = -request.id.load();
+        Cell& cell = find_cell(th.enq_segment_, id, th);
+        if (id > i) {
+            // A helper reserved a cell beyond our last claim; make sure later enqueues land after it
+            int64_t ei = enq_index_.load();
+            while (ei <= id && !enq_index_.compare_exchange_weak(ei, id + 1)) {
+            }
+        }
+        cell.value.store(value);
+    }
+
+    // Returns the value in cell `i`, nullptr if the queue was empty at `i`, or top_value() if the cell is unusable.
+    T* help_enqueue(Handle& th, Cell& cell, int64_t i) {
+        T* v = spin(cell.value);
+        if ((v != top_value() && v != nullptr) ||
+            (v == nullptr && !cell.value.compare_exchange_strong(v, top_value()) && v != top_value())) {
+            return v;
+        }
+
+        // cell.value is TOP: no fast-path enqueue can use this cell, offer it to a pending slow-path enqueue
+        EnqRequest* e = cell.enq.load();
+        if (e == nullptr) {
+            Handle* peer = th.enq_peer_;
+            EnqRequest* peer_request = &peer->enq_request_;
+            int64_t id = peer_request->id.load();
+            if (th.enq_peer_request_id_ != 0 && th.enq_peer_request_id_ != id) {
+                // The peer we kept trying to help has completed that request; move on to the next one
+                th.enq_peer_request_id_ = 0;
+                th.enq_peer_ = peer->next_;
+                peer = th.enq_peer_;
+                peer_request = &peer->enq_request_;
+                id = peer_request->id.load();
+            }
+            if (id > 0 && id <= i && !cell.enq.compare_exchange_strong(e, peer_request) && e != peer_request) {
+                th.enq_peer_request_id_ = id;  // Someone else took this cell; stay with the same peer
+            } else {
+                th.enq_peer_request_id_ = 0;
+                th.enq_peer_ = peer->next_;
+            }
+            if (e == nullptr && cell.enq.compare_exchange_strong(e, top_enq())) {
+                e = top_enq();
+            }
+        }
+
+        if (e == top_enq()) {
+            return enq_index_.load() <= i ? nullptr : top_value();
+        }
+
+        int64_t ei = e->id.load(std::memory_order_acquire);
+        T* ev = e->value.load(std::memory_order_acquire);
+        if (ei > i) {
+            // The request started after this cell and can never be placed here
+            if (cell.value.load() == top_value() && enq_index_.load() <= i) {
+                return nullptr;
+            }
+        } else if ((ei > 0 && e->id.compare_exchange_strong(ei, -i)) ||
+                   (ei == -i && cell.value.load() == top_value())) {
+            int64_t enq_index = enq_index_.load();
+            while (enq_index <= i && !enq_index_.compare_exchange_weak(enq_index, i + 1)) {
+            }
+            cell.value.store(ev);
+        }
+        return cell.value.load();
+    }
+
+    T* dequeue_fast(Handle& th, int64_t& id) {
+        const int64_t i = deq_index_.fetch_add(1);
+        Cell& cell = find_cell(th.deq_segment_, i, th);
+        T* v = help_enqueue(th, cell, i);
+        if (v == nullptr) {
+            return nullptr;
+        }
+        DeqRequest* expected = nullptr;
+        if (v != top_value() && cell.deq.compare_exchange_strong(expected, top_deq())) {
+            return v;
+        }
+        id = i;
+        return top_value();
+    }
+
+    T* dequeue_slow(Handle& th, int64_t id) {
+        DeqRequest& request = th.deq_request_;
+        request.id.store(id, std::memory_order_release);
+        request.idx.store(id, std::memory_order_release);
+
+        help_dequeue(th, th);
+        const int64_t i = -request.idx.load();
+        Cell& cell = find_cell(th.deq_segment_, i, th);
+        T* v = cell.value.load();
+        return v == top_value() ? nullptr : v;
+    }
+
+    void help_dequeue(Handle& th, Handle& peer) {
+        DeqRequest& request = peer.deq_request_;
+        int64_t idx = request.idx.load(std::memory_order_acquire);
+        const int64_t id = request.id.load();
+        if (idx < id) {
+            return;  // Nothing pending
+        }
+
+        // Borrow the peer's hazard before touching its segments. Only ever lower our own, because our own
+        // deq_segment_ must stay protected until the operation ends.
+        Segment* deq_segment = peer.deq_segment_.load();
+        const int64_t peer_hazard = peer.hazard_segment_id_.load();
+        if (peer_hazard < th.hazard_segment_id_.load(std::memory_order_relaxed)) {
+            th.hazard_segment_id_.store(peer_hazard);
+        }
+        idx = request.idx.load();
+
+        int64_t i = id + 1;
+        int64_t old = id;
+        int64_t candidate = 0;
+        for (;;) {
+            // Look for a candidate: a cell holding an unclaimed value, or one proving the queue was empty
+            Segment* segment = deq_segment;
+            for (; idx == old && candidate == 0; ++i) {
+                Cell& cell = find_cell(segment, i, th);
+                int64_t deq_index = deq_index_.load();
+                while (deq_index <= i && !deq_index_.compare_exchange_weak(deq_index, i + 1)) {
+                }
+                T* v = help_enqueue(th, cell, i);
+                if (v == nullptr || (v != top_value() && cell.deq.load() == nullptr)) {
+                    candidate = i;
+                } else {
+                    idx = request.idx.load(std::memory_order_acquire);
+                }
+            }
+            if (candidate != 0) {
+                if (request.idx.compare_exchange_strong(idx, candidate)) {
+                    idx = candidate;
+                }
+                if (idx >= candidate) {
+                    candidate = 0;
+                }
+            }
+            if (idx < 0 || request.id.load() != id) {
+                break;
+            }
+
+            // Try to claim the announced candidate for the request
+            Cell& cell = find_cell(deq_segment, idx, th);
+            DeqRequest* expected = nullptr;
+            if (cell.value.load() == top_value() || cell.deq.compare_exchange_strong(expected, &request) ||
+                expected == &request) {
+                request.idx.compare_exchange_strong(idx, -idx);
+                break;
+            }
+            old = idx;
+            if (idx >= i) {
+                i = idx + 1;
+            }
+        }
+    }
+
+    // Re-reads the handle's hazard and lowers `curr` to the segment it protects.
+    static Segment* check_hazard(const Handle& handle, Segment* curr, Segment* oldest) {
+        const int64_t hazard = handle.hazard_segment_id_.load();
+        if (hazard < curr->id) {
+            Segment* segment = oldest;
+            while (segment->id < hazard) {
+                segment = segment->next.load(std::memory_order_acquire);
+            }
+            curr = segment;
+        }
+        return curr;
+    }
+
+    // Moves an idle handle's cursor forward to `curr` so it does not pin old segments.
+    static Segment* update_cursor(std::atomic<Segment*>& cursor, Segment* curr, const Handle& handle,
+                                  Segment* oldest) {
+        Segment* ptr = cursor.load();
+        if (ptr->id < curr->id) {
+            if (!cursor.compare_exchange_strong(ptr, curr) && ptr->id < curr->id) {
+                curr = ptr;  // The owner moved it concurrently, so it is still in use
+            }
+            curr = check_hazard(handle, curr, oldest);
+        }
+        return curr;
+    }
+
+    void cleanup(Handle& th) {
+        int64_t oldest_id = head_index_.load(std::memory_order_acquire);
+        Segment* curr = th.deq_segment_.load();
+        if (oldest_id == -1 || curr->id - oldest_id < static_cast<int64_t>(2 * max_threads_)) {
+            return;
+        }
+        // head_index_ == -1 doubles as the reclamation lock
+        if (!head_index_.compare_exchange_strong(oldest_id, -1, std::memory_order_acquire)) {
+            return;
+        }
+
+        // Cursors may be advanced up to our deq_segment_. Push the enqueue index past the dequeue index so that no
+        // enqueuer can later be handed a cell behind its (advanced) cursor.
+        const int64_t deq_index = deq_index_.load();
+        int64_t enq_index = enq_index_.load();
+        while (enq_index <= deq_index && !enq_index_.compare_exchange_weak(enq_index, deq_index + 1)) {
+        }
+
+        Segment* oldest = head_segment_;
+        std::vector<Handle*>& visited = th.cleanup_scratch_;
+        visited.clear();
+        Handle* handle = &th;
+        do {
+            curr = check_hazard(*handle, curr, oldest);
+            curr = update_cursor(handle->enq_segment_, curr, *handle, oldest);
+            curr = update_cursor(handle->deq_segment_, curr, *handle, oldest);
+            visited.push_back(handle);
+            handle = handle->next_;
+        } while (curr->id > oldest_id && handle != &th);
+        // Second pass: catches handles that published a hazard after we looked at them but loaded a cursor
+        // before we advanced it
+        while (curr->id > oldest_id && !visited.empty()) {
+            curr = check_hazard(*visited.back(), curr, oldest);
+            visited.pop_back();
+        }
+
+        if (curr->id <= oldest_id) {
+            head_index_.store(oldest_id, std::memory_order_release);
+            return;
+        }
+        head_segment_ = curr;
+        head_index_.store(curr->id, std::memory_order_release);
+        while (oldest != curr) {
+            Segment* next = oldest->next.load(std::memory_order_relaxed);
+            delete oldest;
+            oldest = next;
+        }
+    }
+
+    const size_t max_threads_;
+    std::unique_ptr<Handle[]> handles_;
+    std::atomic<size_t> registered_{0};
+    Segment* head_segment_ = nullptr;  // Oldest live segment; owned by whoever holds the reclamation lock
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<int64_t> enq_index_{1};  // Request ids must be > 0, so start at 1
+    char pad0[CACHE_LINE_SIZE_ - sizeof(enq_index_)]{};
+    alignas(CACHE_LINE_SIZE_) std::atomic<int64_t> deq_index_{1};
+    char pad1[CACHE_LINE_SIZE_ - sizeof(deq_index_)]{};
+    alignas(CACHE_LINE_SIZE_) std::atomic<int64_t> head_index_{0};
+    char pad2[CACHE_LINE_SIZE_ - sizeof(head_index_)]{};
+};
+
+}  // namespace lockfreekit
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+namespace lockfreekit {
+
+// Bounded Chase-Lev work-stealing deque, with the memory orders of Lê, Pop, Cohen and Zappa Nardelli
+// ("Correct and Efficient Work-Stealing for Weak Memory Models").
+//
+// The owner thread pushes and pops at the bottom (LIFO, cache-warm); any other thread steals from the top (FIFO).
+// Elements are small trivially copyable handles such as pointers.
+template <typename T>
+requires std::is_trivially_copyable_v<T>
+class WorkStealingDeque {
+   public:
+    // `capacity` must be a power of two
+    explicit WorkStealingDeque(size_t capacity)
+        : capacity_(capacity), mask_(capacity - 1), buffer_(std::make_unique<std::atomic<T>[]>(capacity)) {
+        if (capacity_ < 1 || (capacity_ & mask_) != 0) {
+            throw std::invalid_argument("Deque capacity must be a power of two");
+        }
+    }
+
+    // Owner only. Returns false when full.
+    [[nodiscard]] bool push(T value) noexcept {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t >= static_cast<int64_t>(capacity_)) {
+            return false;  // Full
+        }
+        buffer_[static_cast<size_t>(b) & mask_].store(value, std::memory_order_relaxed);
+        // Release: a thief that sees the new bottom_ also sees the element (the paper's release fence, folded into
+        // the store)
+        bottom_.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only.
+    [[nodiscard]] std::optional<T> pop() noexcept {
+        const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        // The store of bottom_ must be ordered before the load of top_, or a thief and the owner could both take
+        // the last element
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;  // Empty
+        }
+        T value = buffer_[static_cast<size_t>(b) & mask_].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Last element: race the thieves for it through top_
+            const bool won =
+                top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            if (!won) {
+                return std::nullopt;
+            }
+        }
+        return value;
+    }
+
+    // Any thread. Returns nullopt when empty or when it lost a race; callers simply try elsewhere.
+    [[nodiscard]] std::optional<T> steal() noexcept {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return std::nullopt;  // Empty
+        }
+        T value = buffer_[static_cast<size_t>(t) & mask_].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return std::nullopt;  // Lost to the owner or another thief
+        }
+        return value;
+    }
+
+    [[nodiscard]] size_t approx_size() const noexcept {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+    // Delete copy/move constructors and assignment operators
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+    WorkStealingDeque(WorkStealingDeque&&) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+   private:
+    static constexpr size_t CACHE_LINE_SIZE_ = 64;
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<std::atomic<T>[]> buffer_;
+
+    alignas(CACHE_LINE_SIZE_) std::atomic<int64_t> top_{0};  // Thieves' end
+    char pad0[CACHE_LINE_SIZE_ - sizeof(top_)]{};
+    alignas(CACHE_LINE_SIZE_) std::atomic<int64_t> bottom_{0};  // Owner's end
+    char pad1[CACHE_LINE_SIZE_ - sizeof(bottom_)]{};
+};
+
+}  // namespace lockfreekit
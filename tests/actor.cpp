@@ -0,0 +1,122 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "actor.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+
+struct Increment : IntrusiveMPSCNode {
+    uint32_t seq = 0;
+};
+
+// Checks that messages from one sender arrive in order and that activations never overlap.
+class Counter : public Actor<Increment> {
+   public:
+    Counter(ActorRuntime& runtime, std::atomic<uint32_t>& total) : Actor(runtime, 8), total_(total) {}
+
+    bool ok() const { return ok_; }
+
+   private:
+    void receive(Increment* message) override {
+        if (running_.exchange(true) || message->seq != next_seq_) {
+            ok_ = false;
+        }
+        ++next_seq_;
+        running_.store(false);
+        total_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint32_t>& total_;
+    std::atomic<bool> running_{false};
+    uint32_t next_seq_ = 0;
+    bool ok_ = true;
+};
+
+struct Token : IntrusiveMPSCNode {
+    uint32_t hops_left = 0;
+};
+
+// Passes a token around a ring of actors, sending from worker threads.
+class RingNode : public Actor<Token> {
+   public:
+    RingNode(ActorRuntime& runtime, std::atomic<uint32_t>& finished) : Actor(runtime), finished_(finished) {}
+
+    RingNode* next = nullptr;
+
+   private:
+    void receive(Token* token) override {
+        if (token->hops_left-- == 0) {
+            finished_.fetch_add(1);
+            return;
+        }
+        next->send(token);
+    }
+
+    std::atomic<uint32_t>& finished_;
+};
+
+template <typename Done>
+void wait_until(Done&& done) {
+    while (!done()) {
+        std::this_thread::yield();
+    }
+}
+
+}  // namespace
+
+int main() {
+    constexpr size_t actors = 64;
+    constexpr uint32_t per_actor = 2000;
+    constexpr size_t ring_size = 16;
+    constexpr size_t tokens = 8;
+
+    // Actors and messages must outlive the runtime: a worker may still be finishing an activation when the last
+    // message has been handled
+    std::atomic<uint32_t> total{0};
+    std::atomic<uint32_t> finished{0};
+    std::vector<std::unique_ptr<Counter>> counters;
+    std::vector<std::vector<Increment>> messages(actors, std::vector<Increment>(per_actor));
+    std::vector<std::unique_ptr<RingNode>> ring;
+    std::vector<Token> token_storage(tokens);
+
+    ActorRuntime runtime(4);
+    bool ok = true;
+
+    // Many actors, messages sent from outside the pool
+    for (size_t a = 0; a < actors; ++a) {
+        counters.push_back(std::make_unique<Counter>(runtime, total));
+    }
+    for (uint32_t i = 0; i < per_actor; ++i) {
+        for (size_t a = 0; a < actors; ++a) {
+            messages[a][i].seq = i;
+            counters[a]->send(&messages[a][i]);
+        }
+    }
+    wait_until([&] { return total.load() == actors * per_actor; });
+    for (auto& counter : counters) {
+        ok &= counter->ok();
+    }
+    std::cout << "Counters received " << total.load() << " messages\n";
+
+    // Tokens hopping around a ring, sent from inside the pool
+    for (size_t i = 0; i < ring_size; ++i) {
+        ring.push_back(std::make_unique<RingNode>(runtime, finished));
+    }
+    for (size_t i = 0; i < ring_size; ++i) {
+        ring[i]->next = ring[(i + 1) % ring_size].get();
+    }
+    for (size_t t = 0; t < tokens; ++t) {
+        token_storage[t].hops_left = 10000;
+        ring[t]->send(&token_storage[t]);
+    }
+    wait_until([&] { return finished.load() == tokens; });
+    std::cout << "Ring finished " << finished.load() << " tokens\n";
+
+    std::cout << "Actor runtime: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
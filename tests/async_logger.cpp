@@ -0,0 +1,126 @@
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "async_logger.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+
+enum class Side { buy, sell };
+
+// Reads back what was written to a temporary file
+std::string contents(std::FILE* file) {
+    std::string text;
+    std::rewind(file);
+    char buffer[4096];
+    for (size_t n; (n = std::fread(buffer, 1, sizeof(buffer), file)) > 0;) {
+        text.append(buffer, n);
+    }
+    return text;
+}
+
+size_t count(const std::string& text, const std::string& needle) {
+    size_t found = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        ++found;
+    }
+    return found;
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+
+    // Example: mixed argument types, a filtered debug message
+    {
+        AsyncLogger logger(STDOUT_FILENO);
+        const std::string venue = "XNAS";
+        logger.info("order %llu %s %d @ %.2f on %s", 42ULL, "AAPL", 100, 187.25, venue);
+        logger.warning("side=%d pointer=%p", Side::sell, static_cast<void*>(nullptr));
+        ok &= !logger.log(LogLevel::debug, "not shown");
+        logger.error("done");
+    }
+    std::cout << "\n";
+
+    // Array arguments are captured decayed: an int array as its address, a char array as its text
+    {
+        std::FILE* file = std::tmpfile();
+        int samples[64] = {};
+        char symbol[16] = "MSFT";
+        {
+            AsyncLogger logger(fileno(file));
+            logger.info("samples at %p symbol %s", samples, symbol);
+        }
+        char expected[64];
+        std::snprintf(expected, sizeof(expected), "samples at %p symbol MSFT", static_cast<void*>(samples));
+        const bool captured = count(contents(file), expected) == 1;
+        std::cout << "Array arguments: " << (captured ? "captured as pointer and text" : "WRONG") << "\n";
+        ok &= captured;
+        std::fclose(file);
+    }
+
+    // Stress: 4 threads log concurrently with the blocking policy, nothing may be lost or torn
+    constexpr int threads = 4;
+    constexpr int per_thread = 20000;
+    std::FILE* file = std::tmpfile();
+    {
+        AsyncLogger logger(fileno(file), 1024);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                for (int i = 0; i < per_thread; ++i) {
+                    logger.info("thread %d message %d payload %s", t, i, "abcdefghijklmnopqrstuvwxyz");
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        logger.flush();
+    }
+    const std::string text = contents(file);
+    ok &= count(text, "\n") == threads * per_thread &&
+          count(text, "payload abcdefghijklmnopqrstuvwxyz\n") == threads * per_thread &&
+          text.find("thread 3 message 19999 payload") != std::string::npos;
+    std::fclose(file);
+
+    // A tiny queue with drop_and_count: whatever does not fit is reported as dropped
+    file = std::tmpfile();
+    int accepted = 0;
+    {
+        AsyncLogger logger(fileno(file), 4, OverflowPolicy::drop_and_count);
+        for (int i = 0; i < 1000; ++i) {
+            accepted += logger.info("burst %d", i) ? 1 : 0;
+        }
+    }
+    const std::string burst = contents(file);
+    ok &= count(burst, "burst ") == static_cast<size_t>(accepted) &&
+          (accepted == 1000 || burst.find("messages dropped") != std::string::npos);
+    std::fclose(file);
+
+    // Call-site cost with a queue that has room
+    file = std::tmpfile();
+    {
+        constexpr int calls = 10000;
+        AsyncLogger logger(fileno(file), 2 * calls);
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < calls; ++i) {
+            logger.info("latency sample %d %f", i, 0.5);
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+        std::cout << "Call-site cost: ~" << static_cast<int>(elapsed.count() / calls) << " ns per message\n";
+    }
+    std::fclose(file);
+
+    std::cout << "Async logger: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "atomic_shared_ptr.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+
+std::atomic<int64_t> live_configs{0};
+
+// Both fields are written together; a reader seeing them disagree saw a freed or half-built object
+struct Config {
+    explicit Config(uint64_t generation) : generation(generation), doubled(generation * 2) {
+        live_configs.fetch_add(1);
+    }
+    ~Config() {
+        doubled = 1;  // Odd, so a use after free is likely to trip the check
+        live_configs.fetch_sub(1);
+    }
+    uint64_t generation;
+    uint64_t doubled;
+};
+
+template <typename Load>
+double load_cost(int threads, int per_thread, Load&& load) {
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < per_thread; ++i) {
+                load();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+           (static_cast<double>(threads) * per_thread);
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+
+    // Example: load, exchange, compare_exchange, version
+    {
+        AtomicSharedPtr<Config> config(std::make_shared<Config>(1));
+        std::shared_ptr<Config> seen = config.load();
+        const auto old = config.exchange(std::make_shared<Config>(2));
+        std::cout << "Loaded generation " << seen->generation << ", exchanged out " << old->generation << ", now "
+                  << config.load()->generation << ", version " << config.version() << "\n";
+        ok &= seen == old && config.load()->generation == 2 && config.version() == 1;
+
+        std::shared_ptr<Config> expected = seen;  // Stale
+        ok &= !config.compare_exchange_strong(expected, std::make_shared<Config>(3)) && expected->generation == 2;
+        ok &= config.compare_exchange_strong(expected, std::make_shared<Config>(3)) && config.load()->generation == 3;
+
+        config.store(nullptr);
+        ok &= config.load() == nullptr;
+        expected = nullptr;
+        ok &= config.compare_exchange_strong(expected, std::make_shared<Config>(4)) && config.load()->generation == 4;
+    }
+    ok &= live_configs == 0;
+
+    // Stress: readers load and check objects while writers keep replacing them (with store and with
+    // compare_exchange); every object must be destroyed exactly once, after its last reader
+    {
+        constexpr int readers = 6;
+        constexpr int writers = 2;
+        constexpr uint64_t swaps = 50000;
+        AtomicSharedPtr<Config> config(std::make_shared<Config>(0));
+        std::atomic<int> writing{writers};
+        std::atomic<bool> broken{false};
+        std::atomic<uint64_t> loads{0};
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r] {
+                SharedPtrCache<Config> cache;
+                uint64_t local = 0;
+                while (writing.load() > 0) {
+                    const std::shared_ptr<Config> current = r % 2 == 0 ? config.load() : cache.get(config);
+                    if (current->doubled != current->generation * 2) {
+                        broken = true;
+                    }
+                    ++local;
+                }
+                loads.fetch_add(local);
+            });
+        }
+        for (int w = 0; w < writers; ++w) {
+            threads.emplace_back([&, w] {
+                for (uint64_t i = 1; i <= swaps; ++i) {
+                    if (w == 0) {
+                        config.store(std::make_shared<Config>(i));
+                    } else {
+                        std::shared_ptr<Config> expected = config.load();
+                        (void)config.compare_exchange_strong(expected, std::make_shared<Config>(i));
+                    }
+                }
+                writing.fetch_sub(1);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        std::cout << loads << " loads during " << writers * swaps << " swaps: "
+                  << (broken ? "BROKEN object seen" : "every object intact") << ", live objects " << live_configs
+                  << "\n";
+        ok &= !broken && live_configs == 1;
+    }
+    ok &= live_configs == 0;
+
+    // Load cost: split counts, the version-checked cache, and std::atomic<std::shared_ptr>
+    {
+        const int threads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+        constexpr int per_thread = 500000;
+        AtomicSharedPtr<Config> split(std::make_shared<Config>(1));
+        std::atomic<std::shared_ptr<Config>> standard(std::make_shared<Config>(1));
+        const double split_ns = load_cost(threads, per_thread, [&] { (void)split.load(); });
+        const double cached_ns = load_cost(threads, per_thread, [&] {
+            thread_local SharedPtrCache<Config> cache;
+            (void)cache.get(split);
+        });
+        const double standard_ns = load_cost(threads, per_thread, [&] { (void)standard.load(); });
+        std::cout << threads << " readers: AtomicSharedPtr ~" << split_ns << " ns, cached ~" << cached_ns
+                  << " ns, std::atomic<std::shared_ptr> ~" << standard_ns << " ns per load\n";
+    }
+
+    std::cout << "Atomic shared pointer: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "barriers.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+
+// Every participant stamps its slot with the phase, then checks after the barrier that everyone did: a
+// participant let through early sees a stale stamp
+template <typename Barrier>
+bool phases_hold(const char* name, Barrier& barrier, size_t participants, uint64_t phases) {
+    std::vector<uint64_t> stamps(participants, 0);
+    std::atomic<bool> broken{false};
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < participants; ++p) {
+        threads.emplace_back([&, p] {
+            for (uint64_t phase = 1; phase <= phases; ++phase) {
+                stamps[p] = phase;
+                barrier.arrive_and_wait(p);
+                for (size_t other = 0; other < participants; ++other) {
+                    if (stamps[other] != phase) {
+                        broken = true;
+                    }
+                }
+                barrier.arrive_and_wait(p);  // Nobody stamps the next phase before everyone checked
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::cout << name << " with " << participants << " participants, " << phases
+              << " phases: " << (broken ? "BROKEN" : "ok") << "\n";
+    return !broken;
+}
+
+template <typename ArriveAndWait>
+double phase_cost(size_t participants, uint64_t phases, ArriveAndWait&& arrive_and_wait) {
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t p = 0; p < participants; ++p) {
+        threads.emplace_back([&, p] {
+            for (uint64_t phase = 0; phase < phases; ++phase) {
+                arrive_and_wait(p);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+           static_cast<double>(phases);
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+
+    // Example: a latch that starts workers together
+    {
+        constexpr uint32_t workers = 3;
+        Latch ready(workers);
+        Latch go(1);
+        std::atomic<int> started{0};
+        std::vector<std::thread> threads;
+        for (uint32_t w = 0; w < workers; ++w) {
+            threads.emplace_back([&] {
+                ready.count_down();
+                go.wait();
+                started.fetch_add(1);
+            });
+        }
+        ready.wait();
+        ok &= ready.try_wait() && !go.try_wait() && started == 0;
+        go.count_down();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        std::cout << "Latch released " << started << " workers at once\n";
+        ok &= started == static_cast<int>(workers);
+        Latch open(0);
+        ok &= open.try_wait();
+    }
+
+    // Stress: uneven trees (participants not a power of the fan-in), dissemination at odd counts, and a
+    // single participant
+    for (const size_t participants : {1, 3, 5, 8}) {
+        TreeBarrier tree(participants);
+        ok &= phases_hold("TreeBarrier", tree, participants, 2000);
+        DisseminationBarrier dissemination(participants);
+        ok &= phases_hold("DisseminationBarrier", dissemination, participants, 2000);
+    }
+    {
+        TreeBarrier binary(7, 2);
+        ok &= phases_hold("TreeBarrier (fan-in 2)", binary, 7, 2000);
+    }
+
+    // Cost per phase against std::barrier
+    {
+        const size_t participants = std::max(4u, std::thread::hardware_concurrency());
+        constexpr uint64_t phases = 5000;
+        TreeBarrier tree(participants);
+        DisseminationBarrier dissemination(participants);
+        std::barrier standard(static_cast<std::ptrdiff_t>(participants));
+        const double tree_us = phase_cost(participants, phases, [&](size_t p) { tree.arrive_and_wait(p); });
+        const double dissemination_us =
+            phase_cost(participants, phases, [&](size_t p) { dissemination.arrive_and_wait(p); });
+        const double standard_us = phase_cost(participants, phases, [&](size_t) { standard.arrive_and_wait(); });
+        std::cout << participants << " participants: TreeBarrier ~" << tree_us << " us, DisseminationBarrier ~"
+                  << dissemination_us << " us, std::barrier ~" << standard_us << " us per phase\n";
+    }
+
+    std::cout << "Barriers: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "bravo_rw_lock.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+
+// Plain fields the lock protects: a reader seeing them disagree ran alongside a writer
+struct Table {
+    uint64_t version = 0;
+    uint64_t checksum = 0;
+};
+
+template <typename ReadOnce>
+double read_cost(int threads, int per_thread, ReadOnce&& read_once) {
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < per_thread; ++i) {
+                read_once();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+           (static_cast<double>(threads) * per_thread);
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+
+    // Example: fast readers, a writer revoking the bias, the bias coming back after the inhibit period
+    {
+        BravoRwLock lock;
+        Table table;
+        {
+            BravoRwLock::ReadLock read(lock);
+            ok &= lock.reader_biased() && table.version == 0;
+            ok &= !lock.try_lock();  // Fast reader inside
+        }
+        {
+            std::unique_lock write(lock);
+            table.version = 1;
+            table.checksum = 2;
+        }
+        std::cout << "After a write: reader biased " << lock.reader_biased() << "\n";
+        ok &= !lock.reader_biased();
+        {
+            BravoRwLock::ReadLock read(lock);  // Slow path, still inhibited
+            ok &= table.version == 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        { BravoRwLock::ReadLock read(lock); }  // Slow path, turns the bias back on
+        std::cout << "After the inhibit period: reader biased " << lock.reader_biased() << "\n";
+        ok &= lock.reader_biased();
+        ok &= lock.try_lock();
+        lock.unlock();
+    }
+
+    // Stress: readers on both paths and writers; readers must never see a half-written table, and the
+    // writers' increments must all land
+    {
+        constexpr int readers = 6;
+        constexpr int writers = 2;
+        constexpr int writes = 5000;
+        BravoRwLock lock(4);  // Fewer slots than readers, so slots are shared
+        Table table;
+        std::atomic<int> writing{writers};
+        std::atomic<bool> broken{false};
+        std::atomic<uint64_t> reads{0};
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&] {
+                uint64_t local = 0;
+                while (writing.load(std::memory_order_relaxed) > 0) {
+                    BravoRwLock::ReadLock read(lock);
+                    if (table.checksum != table.version * 2) {
+                        broken = true;
+                    }
+                    ++local;
+                }
+                reads.fetch_add(local);
+            });
+        }
+        for (int w = 0; w < writers; ++w) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < writes; ++i) {
+                    std::lock_guard write(lock);
+                    ++table.version;
+                    table.checksum = table.version * 2;
+                }
+                writing.fetch_sub(1);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        std::cout << reads << " reads alongside " << writers * writes
+                  << " writes: " << (broken ? "BROKEN table seen" : "every read consistent") << ", version "
+                  << table.version << "\n";
+        ok &= !broken && table.version == static_cast<uint64_t>(writers) * writes;
+    }
+
+    // Read-side cost without writers, against std::shared_mutex
+    {
+        const int threads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+        constexpr int per_thread = 2000000;
+        BravoRwLock bravo;
+        std::shared_mutex standard;
+        const double bravo_ns = read_cost(threads, per_thread, [&] { BravoRwLock::ReadLock read(bravo); });
+        const double standard_ns = read_cost(threads, per_thread, [&] { std::shared_lock read(standard); });
+        std::cout << threads << " readers: BravoRwLock ~" << bravo_ns << " ns, std::shared_mutex ~" << standard_ns
+                  << " ns per read lock/unlock\n";
+    }
+
+    std::cout << "BRAVO reader-writer lock: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
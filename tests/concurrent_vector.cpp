@@ -0,0 +1,123 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_vector.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+
+struct Event {
+    uint32_t thread = 0;
+    uint32_t sequence = 0;
+    uint64_t check = 0;  // Derived from the other two, to catch half-constructed reads
+};
+
+uint64_t checksum(uint32_t thread, uint32_t sequence) {
+    return (uint64_t{thread} << 32 | sequence) * 0x9e3779b97f4a7c15ULL;
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+
+    // Example: indices come back in push order from one thread, references survive growth
+    {
+        ConcurrentVector<std::string> names;
+        const size_t first = names.push_back("alpha");
+        const std::string* address = &names[first];
+        for (int i = 0; i < 1000; ++i) {
+            names.emplace_back(std::to_string(i));
+        }
+        std::cout << "size " << names.size() << ", [0] " << names[0] << ", [1000] " << names[1000]
+                  << ", first element moved: " << (address != &names[first] ? "yes" : "no") << "\n";
+        ok &= names.size() == 1001 && address == &names[first] && *address == "alpha" && names[1000] == "999";
+    }
+
+    // Stress: 8 writers append while a reader walks the published prefix; every element below size() must be
+    // complete, and in the end each writer's elements must all be there, in its own order
+    {
+        constexpr uint32_t threads = 8;
+        constexpr uint32_t per_thread = 100000;
+        ConcurrentVector<Event> events;
+        std::atomic<uint32_t> running{threads};
+        std::atomic<bool> torn{false};
+        size_t reads = 0;
+        std::vector<std::thread> workers;
+        for (uint32_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                for (uint32_t i = 0; i < per_thread; ++i) {
+                    events.push_back(Event{t, i, checksum(t, i)});
+                }
+                running.fetch_sub(1);
+            });
+        }
+        std::thread reader([&] {
+            size_t seen = 0;
+            while (running.load() > 0 || seen < events.size()) {
+                for (const size_t size = events.size(); seen < size; ++seen) {
+                    const Event& event = events[seen];
+                    torn = torn || event.check != checksum(event.thread, event.sequence);
+                    ++reads;
+                }
+            }
+        });
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        reader.join();
+
+        std::vector<uint32_t> next(threads, 0);
+        bool ordered = events.size() == size_t{threads} * per_thread;
+        for (size_t i = 0; ordered && i < events.size(); ++i) {
+            const Event& event = events[i];
+            ordered = event.sequence == next[event.thread]++;
+        }
+        std::cout << "Published " << events.size() << " events, reader checked " << reads
+                  << ", torn: " << (torn ? "yes" : "none") << ", per-thread order: " << (ordered ? "kept" : "BROKEN")
+                  << "\n";
+        ok &= !torn && ordered && reads == events.size();
+    }
+
+    // Cost against a mutex around std::vector::push_back
+    {
+        constexpr int threads = 4;
+        constexpr int per_thread = 250000;
+        auto time = [&](auto&& append) {
+            std::vector<std::thread> workers;
+            const auto start = std::chrono::steady_clock::now();
+            for (int t = 0; t < threads; ++t) {
+                workers.emplace_back([&] {
+                    for (int i = 0; i < per_thread; ++i) {
+                        append(i);
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                   (threads * per_thread);
+        };
+        std::mutex mutex;
+        std::vector<int> locked;
+        ConcurrentVector<int> concurrent;
+        const double locked_ns = time([&](int i) {
+            std::lock_guard lock(mutex);
+            locked.push_back(i);
+        });
+        const double concurrent_ns = time([&](int i) { concurrent.push_back(i); });
+        std::cout << "Append: mutex + vector ~" << locked_ns << " ns, concurrent vector ~" << concurrent_ns << " ns\n";
+        ok &= concurrent.size() == locked.size();
+    }
+
+    std::cout << "Concurrent vector: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
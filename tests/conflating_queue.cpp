@@ -0,0 +1,87 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "conflating_queue.hpp"
+
+namespace {
+
+struct Quote {
+    uint64_t version = 0;
+    double bid = 0;
+    double ask = 0;
+};
+
+}  // namespace
+
+int main() {
+    using namespace lockfreekit;
+
+    // Example: three ticks for instrument 2 collapse into its newest quote, keys keep first-arrival order
+    ConflatingQueue<Quote> book(4);
+    book.push(2, Quote{1, 100.0, 100.5});
+    book.push(0, Quote{1, 50.0, 50.25});
+    book.push(2, Quote{2, 100.25, 100.75});
+    book.push(2, Quote{3, 100.5, 101.0});
+    std::cout << "Pending keys: " << book.approx_size() << "\n";
+    while (auto update = book.pop()) {
+        std::cout << "Instrument " << update->key << ": v" << update->value.version << " " << update->value.bid
+                  << "/" << update->value.ask << "\n";
+    }
+    std::cout << "\n";
+
+    // Stress: producers tick their own instruments with increasing versions, a slow consumer must only ever see
+    // versions move forward and must end with the final version of every instrument
+    constexpr size_t keys = 256;
+    constexpr int producers = 3;
+    constexpr uint64_t ticks = 300000;
+    ConflatingQueue<Quote> queue(keys);
+    std::vector<uint64_t> seen(keys, 0);
+    std::vector<uint64_t> final_version(keys, 0);
+    std::atomic<int> running{producers};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            std::vector<uint64_t> version(keys, 0);
+            for (uint64_t i = 0; i < ticks; ++i) {
+                const size_t key = (i * 37 % (keys / producers)) * producers + p;
+                ++version[key];
+                queue.push(key, Quote{version[key], static_cast<double>(version[key]), static_cast<double>(key)});
+            }
+            for (size_t key = p; key < keys; key += producers) {
+                final_version[key] = version[key];
+            }
+            running.fetch_sub(1);
+        });
+    }
+
+    bool ok = true;
+    uint64_t popped = 0;
+    for (;;) {
+        const bool done = running.load() == 0;
+        auto update = queue.pop();
+        if (!update) {
+            if (done) {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        ++popped;
+        const Quote& quote = update->value;
+        ok &= quote.version >= seen[update->key] && quote.bid == static_cast<double>(quote.version) &&
+              quote.ask == static_cast<double>(update->key);
+        seen[update->key] = quote.version;
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    ok &= seen == final_version;
+    std::cout << "Conflating queue stress: " << (ok ? "passed" : "FAILED") << " (" << popped << " pops for "
+              << producers * ticks << " ticks)\n";
+    return ok ? 0 : 1;
+}
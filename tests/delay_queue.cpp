@@ -0,0 +1,102 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "delay_queue.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+using Clock = std::chrono::steady_clock;
+
+struct Retry {
+    uint64_t id = 0;
+    Clock::time_point deadline{};
+};
+
+// Producers schedule items 0..max_delay ahead, consumers check that nothing comes out before its deadline
+bool stress(Clock::duration resolution, std::chrono::microseconds max_delay) {
+    constexpr int producers = 3;
+    constexpr int consumers = 2;
+    constexpr uint64_t per_producer = 3000;
+    DelayQueue<Retry> queue(4096, resolution);
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> early{0};
+
+    std::vector<std::thread> threads;
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            while (auto retry = queue.pop()) {
+                if (Clock::now() < retry->deadline) {
+                    early.fetch_add(1);
+                }
+                received.fetch_add(1);
+            }
+        });
+    }
+    std::vector<std::thread> pushers;
+    for (int p = 0; p < producers; ++p) {
+        pushers.emplace_back([&, p] {
+            uint64_t rng = p + 1;
+            for (uint64_t i = 0; i < per_producer; ++i) {
+                rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+                const auto delay = std::chrono::microseconds((rng >> 33) % max_delay.count());
+                const Retry retry{i, Clock::now() + delay};
+                while (!queue.push_at(retry.deadline, retry)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : pushers) {
+        t.join();
+    }
+    while (received.load() < producers * per_producer) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    queue.close();
+    for (auto& t : threads) {
+        t.join();
+    }
+    return received.load() == producers * per_producer && early.load() == 0;
+}
+
+}  // namespace
+
+int main() {
+    // Example: items come out in deadline order, not push order
+    DelayQueue<int> queue(16);
+    const auto start = Clock::now();
+    (void)queue.push_after(std::chrono::milliseconds(30), 3);
+    (void)queue.push_after(std::chrono::milliseconds(10), 1);
+    (void)queue.push_after(std::chrono::milliseconds(20), 2);
+    std::cout << "Ready right away: " << std::boolalpha << queue.try_pop().has_value() << "\n";
+    for (int i = 0; i < 3; ++i) {
+        const int value = *queue.pop();
+        const auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+        std::cout << "Popped " << value << " after ~" << waited.count() / 10 * 10 << " ms\n";
+    }
+
+    // Items already due when the queue closes still come out; the one not due yet is dropped
+    DelayQueue<int> closing(16);
+    (void)closing.push_after(std::chrono::milliseconds(0), 4);
+    (void)closing.push_after(std::chrono::milliseconds(0), 5);
+    (void)closing.push_after(std::chrono::hours(1), 6);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    closing.close();
+    int drained = 0;
+    while (closing.pop()) {
+        ++drained;
+    }
+    std::cout << "Due items popped after close: " << drained << "\n\n";
+
+    // 1 ms ticks keep delays in the lowest levels; 1 ns ticks push them through every level and the overflow list
+    const bool coarse = stress(std::chrono::milliseconds(1), std::chrono::microseconds(20000));
+    const bool fine = stress(std::chrono::nanoseconds(1), std::chrono::microseconds(50000));
+    const bool ok = drained == 2 && coarse && fine;
+    std::cout << "Delay queue stress: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
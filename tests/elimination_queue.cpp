@@ -0,0 +1,82 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "elimination_queue.hpp"
+
+namespace {
+
+// Producers push (producer, seq) pairs; every consumer must see each producer's items in order, whether they
+// came through the ring or were handed over directly.
+template <typename Queue>
+bool stress(Queue& queue, int producers, int consumers, uint32_t per_producer) {
+    std::atomic<uint32_t> received{0};
+    std::atomic<bool> ok{true};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (uint32_t i = 0; i < per_producer; ++i) {
+                while (!queue.enqueue((uint64_t{static_cast<uint32_t>(p)} << 32) | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            std::vector<int64_t> last(producers, -1);
+            while (received.load() < producers * per_producer) {
+                if (auto val = queue.dequeue()) {
+                    const auto p = static_cast<size_t>(*val >> 32);
+                    const auto seq = static_cast<int64_t>(*val & 0xffffffff);
+                    if (seq <= last[p]) {
+                        ok = false;
+                    }
+                    last[p] = seq;
+                    received.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    return ok && received.load() == producers * per_producer && !queue.dequeue();
+}
+
+}  // namespace
+
+int main() {
+    using namespace lockfreekit;
+
+    // Example: a consumer waits on an empty queue while a producer arrives
+    EliminationQueue<int> queue(8, 1 << 20);
+    std::thread consumer([&] {
+        for (int count = 0; count < 5;) {
+            if (auto val = queue.dequeue()) {
+                std::cout << "Consumed " << *val << " (elimination)\n";
+                ++count;
+            }
+        }
+    });
+    for (int i = 0; i < 5; ++i) {
+        while (!queue.enqueue(i)) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    std::cout << "Elimination queue approx size: " << queue.approx_size() << "\n\n";
+
+    bool ok = true;
+    EliminationQueue<uint64_t> small(4);
+    ok &= stress(small, 3, 3, 30000);
+    EliminationQueue<uint64_t, 64> disabled(0);
+    ok &= stress(disabled, 2, 2, 30000);
+    EliminationQueue<uint64_t> one_to_one(1024, 4096);
+    ok &= stress(one_to_one, 1, 1, 30000);
+    std::cout << "Elimination queue stress: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "epoch_arena.hpp"
+#include "mpmc_queue.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+
+struct Message {
+    const uint8_t* payload = nullptr;
+    uint32_t length = 0;
+    uint8_t fill = 0;
+    EpochArena::Epoch epoch = 0;
+};
+
+struct Point {
+    double x;
+    double y;
+};
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+
+    // Example: an epoch is reset once it is closed and everything in it was released
+    {
+        EpochArena arena(4096);
+        const auto first = arena.epoch();
+        Point* a = arena.create<Point>(1.0, 2.0);
+        Point* b = arena.create<Point>(3.0, 4.0);
+        arena.advance_epoch();
+        arena.release(first);
+        std::cout << "Epoch " << first << " with one of two released: " << arena.collect() << " reset, "
+                  << arena.pending_epochs() << " pending\n";
+        ok &= arena.pending_epochs() == 1 && a->x == 1.0 && b->y == 4.0;
+        arena.release(first);
+        std::cout << "Both released: " << arena.collect() << " reset, " << arena.pending_epochs() << " pending\n";
+        ok &= arena.pending_epochs() == 0;
+        // The next epoch that fills a chunk reuses the freed one instead of growing
+        const size_t reserved = arena.reserved_bytes();
+        arena.advance_epoch();
+        (void)arena.allocate(100);
+        ok &= arena.reserved_bytes() == reserved;
+    }
+
+    // Stress: a producer fills payloads with a per-message byte and passes them through an MPMCQueue to 3
+    // consumers, closing an epoch every 64 messages. A chunk reused too early would show up as a payload whose
+    // bytes changed under the consumer.
+    {
+        constexpr int consumers = 3;
+        constexpr int messages = 300000;
+        EpochArena arena(16 * 1024);
+        MPMCQueue<Message> queue(1024);
+        std::atomic<int> consumed{0};
+        std::atomic<bool> corrupted{false};
+        std::vector<std::thread> workers;
+        for (int c = 0; c < consumers; ++c) {
+            workers.emplace_back([&] {
+                while (consumed.load() < messages) {
+                    const auto message = queue.dequeue();
+                    if (!message) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    for (uint32_t i = 0; i < message->length; ++i) {
+                        if (message->payload[i] != message->fill) {
+                            corrupted = true;
+                        }
+                    }
+                    arena.release(message->epoch);
+                    consumed.fetch_add(1);
+                }
+            });
+        }
+        size_t max_reserved = 0;
+        size_t stalls = 0;
+        for (int m = 0; m < messages; ++m) {
+            const auto length = static_cast<uint32_t>(16 + (m * 37) % 1500);
+            auto* payload = static_cast<uint8_t*>(arena.allocate(length, 1));
+            const auto fill = static_cast<uint8_t>(m);
+            std::memset(payload, fill, length);
+            const Message message{payload, length, fill, arena.epoch()};
+            while (!queue.enqueue(message)) {
+                std::this_thread::yield();
+            }
+            if (m % 64 == 63 && !arena.advance_epoch()) {
+                ++stalls;  // Consumers are behind, keep filling the current epoch
+            }
+            max_reserved = std::max(max_reserved, arena.reserved_bytes());
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        arena.advance_epoch();
+        arena.collect();
+        std::cout << "Corrupted payloads: " << (corrupted ? "yes" : "none") << ", peak reserve " << max_reserved / 1024
+                  << " KiB, " << stalls << " epoch stalls, pending at the end " << arena.pending_epochs() << "\n";
+        ok &= !corrupted && arena.pending_epochs() == 0 && max_reserved < 16 * 1024 * 1024;
+    }
+
+    // Cost against new/delete for the same payload sizes
+    {
+        constexpr int rounds = 1000000;
+        EpochArena arena;
+        std::vector<uint8_t*> batch(64);
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds / 64; ++r) {
+            for (auto& payload : batch) {
+                payload = new uint8_t[256];
+                payload[0] = 1;
+            }
+            for (auto* payload : batch) {
+                delete[] payload;
+            }
+        }
+        const double heap_ns =
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds;
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds / 64; ++r) {
+            const auto epoch = arena.epoch();
+            for (auto& payload : batch) {
+                payload = static_cast<uint8_t*>(arena.allocate(256, 1));
+                payload[0] = 1;
+            }
+            arena.release(epoch, batch.size());
+            arena.advance_epoch();
+        }
+        const double arena_ns =
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds;
+        std::cout << "Allocate + free: new/delete ~" << heap_ns << " ns, arena ~" << arena_ns << " ns\n";
+    }
+
+    std::cout << "Epoch arena: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
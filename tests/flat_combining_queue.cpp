@@ -0,0 +1,69 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "flat_combining_queue.hpp"
+
+int main() {
+    using namespace lockfreekit;
+
+    // Example: single thread, capacity 4, fills up and drains
+    FlatCombiningQueue<int> queue(4, 1);
+    auto& handle = queue.register_thread();
+    for (int i = 0; i < 5; ++i) {
+        const bool ok = queue.enqueue(handle, i);
+        std::cout << (ok ? "Enqueued " : "Queue full, rejected ") << i << " (flat combining)\n";
+    }
+    while (auto val = queue.dequeue(handle)) {
+        std::cout << "Dequeued " << *val << " (flat combining)\n";
+    }
+    std::cout << "Flat combining queue approx size: " << queue.approx_size() << "\n\n";
+
+    // Stress: producers push (producer, seq) pairs, consumers check per-producer FIFO order
+    constexpr int producers = 4;
+    constexpr int consumers = 4;
+    constexpr uint32_t per_producer = 50000;
+    FlatCombiningQueue<uint64_t> shared(64, producers + consumers + 1);
+    std::atomic<uint32_t> received{0};
+    std::atomic<bool> ok{true};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            auto& h = shared.register_thread();
+            for (uint32_t i = 0; i < per_producer; ++i) {
+                while (!shared.enqueue(h, (uint64_t{static_cast<uint32_t>(p)} << 32) | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            auto& h = shared.register_thread();
+            std::vector<int64_t> last(producers, -1);
+            while (received.load() < producers * per_producer) {
+                if (auto val = shared.dequeue(h)) {
+                    const auto p = static_cast<size_t>(*val >> 32);
+                    const auto seq = static_cast<int64_t>(*val & 0xffffffff);
+                    if (seq <= last[p]) {
+                        ok = false;
+                    }
+                    last[p] = seq;
+                    received.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    const bool passed = ok && received.load() == producers * per_producer && !shared.dequeue(shared.register_thread());
+    std::cout << "Flat combining stress: " << (passed ? "passed" : "FAILED") << "\n";
+    return passed ? 0 : 1;
+}
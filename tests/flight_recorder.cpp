@@ -0,0 +1,233 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flight_recorder.hpp"
+#include "mpmc_queue.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+
+// Counts the hook calls, to check that MPMCQueue reports every operation
+struct CountingTracer {
+    std::atomic<uint64_t> enqueues{0};
+    std::atomic<uint64_t> dequeues{0};
+    std::atomic<uint64_t> retries{0};
+
+    void enqueued(uint64_t) noexcept { enqueues.fetch_add(1, std::memory_order_relaxed); }
+    void dequeued(uint64_t) noexcept { dequeues.fetch_add(1, std::memory_order_relaxed); }
+    void cas_retry(uint64_t) noexcept { retries.fetch_add(1, std::memory_order_relaxed); }
+    void full(uint64_t) noexcept {}
+    void empty(uint64_t) noexcept {}
+};
+
+std::vector<TraceEvent> of_thread(const std::vector<TraceEvent>& events, uint32_t thread) {
+    std::vector<TraceEvent> mine;
+    for (const auto& event : events) {
+        if (event.thread == thread) {
+            mine.push_back(event);
+        }
+    }
+    return mine;
+}
+
+// A temporary file that read_binary() can open by name
+std::string temp_path(int& fd) {
+    char path[] = "/tmp/flight_recorder_XXXXXX";
+    fd = mkstemp(path);
+    return path;
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+
+    // Example: a traced scope with an instant and a counter event inside, as Chrome JSON
+    {
+        TraceScope scope("example", 1);
+        FlightRecorder::record("checkpoint");
+        FlightRecorder::record("queue depth", TracePhase::counter, 7);
+    }
+    const auto example = of_thread(FlightRecorder::snapshot(), FlightRecorder::thread_id());
+    FlightRecorder::write_chrome_json(std::cout, example);
+    ok &= example.size() == 4 && example[0].phase == TracePhase::begin && example[3].phase == TracePhase::end &&
+          example[2].arg == 7;
+
+    // Stress: 4 threads record while another keeps snapshotting; no snapshot may hold a torn record (the name
+    // must match the parity of the argument), and each ring ends up with its thread's newest records
+    constexpr int threads = 4;
+    constexpr uint64_t per_thread = 50000;
+    std::vector<uint32_t> ids(threads);
+    std::atomic<int> running{threads};
+    std::atomic<bool> torn{false};
+    size_t snapshots = 0;
+    {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                ids[t] = FlightRecorder::thread_id();
+                for (uint64_t i = 0; i < per_thread; ++i) {
+                    FlightRecorder::record(i % 2 == 0 ? "even" : "odd", TracePhase::instant, i);
+                }
+                running.fetch_sub(1);
+            });
+        }
+        std::thread reader([&] {
+            while (running.load() > 0) {
+                std::map<uint32_t, uint64_t> last;
+                for (const auto& event : FlightRecorder::snapshot()) {
+                    if (event.name != "even" && event.name != "odd") {
+                        continue;
+                    }
+                    if ((event.arg % 2 == 0) != (event.name == "even")) {
+                        torn = true;
+                    }
+                    // Oldest first per thread
+                    if (auto it = last.find(event.thread); it != last.end() && it->second >= event.arg) {
+                        torn = true;
+                    }
+                    last[event.thread] = event.arg;
+                }
+                ++snapshots;
+            }
+        });
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        reader.join();
+    }
+    const auto final_snapshot = FlightRecorder::snapshot();
+    bool rings_ok = true;
+    for (const uint32_t id : ids) {
+        const auto mine = of_thread(final_snapshot, id);
+        rings_ok &= mine.size() == FlightRecorder::RING_CAPACITY &&
+                    mine.front().arg == per_thread - FlightRecorder::RING_CAPACITY && mine.back().arg == per_thread - 1;
+    }
+    std::cout << "Concurrent snapshots: " << snapshots << ", torn records: " << (torn ? "yes" : "none")
+              << ", rings keep the newest records: " << (rings_ok ? "yes" : "no") << "\n";
+    ok &= !torn && rings_ok;
+
+    // A thread started now adopts the ring of one that exited instead of registering a new one
+    uint32_t adopted = 0;
+    std::thread([&] { adopted = FlightRecorder::thread_id(); }).join();
+    ok &= adopted < static_cast<uint32_t>(threads + 1);
+
+    // Binary dump round trip
+    int fd = -1;
+    const std::string path = temp_path(fd);
+    const auto before_dump = FlightRecorder::snapshot();
+    ok &= FlightRecorder::write_binary(fd);
+    close(fd);
+    {
+        std::ifstream in(path, std::ios::binary);
+        const auto loaded = FlightRecorder::read_binary(in);
+        bool same = loaded.size() == before_dump.size();
+        for (size_t i = 0; same && i < loaded.size(); ++i) {
+            same = loaded[i].timestamp_ns == before_dump[i].timestamp_ns && loaded[i].arg == before_dump[i].arg &&
+                   loaded[i].thread == before_dump[i].thread && loaded[i].phase == before_dump[i].phase &&
+                   loaded[i].name == before_dump[i].name;
+        }
+        std::cout << "Binary dump: " << loaded.size() << " records, round trip " << (same ? "exact" : "MISMATCH")
+                  << "\n";
+        ok &= same;
+    }
+    std::remove(path.c_str());
+
+    // MPMCQueue hook: the flight recorder tracer records positions, a counting tracer sees every operation
+    {
+        MPMCQueue<int, 0, size_t, FlightRecorderQueueTracer> queue(4);
+        (void)queue.enqueue(1);
+        (void)queue.enqueue(2);
+        (void)queue.dequeue();
+        (void)queue.dequeue();
+        (void)queue.dequeue();
+        std::vector<std::string> names;
+        for (const auto& event : of_thread(FlightRecorder::snapshot(), FlightRecorder::thread_id())) {
+            if (event.name.rfind("mpmc.", 0) == 0) {
+                names.push_back(event.name + "@" + std::to_string(event.arg));
+            }
+        }
+        const std::vector<std::string> expected = {"mpmc.enqueue@0", "mpmc.enqueue@1", "mpmc.dequeue@0",
+                                                   "mpmc.dequeue@1", "mpmc.empty@2"};
+        ok &= names == expected;
+
+        constexpr int items = 100000;
+        MPMCQueue<uint64_t, 0, size_t, CountingTracer> counted(64);
+        std::atomic<int> consumed{0};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 2; ++t) {
+            workers.emplace_back([&] {
+                for (int i = 0; i < items / 2; ++i) {
+                    while (!counted.enqueue(static_cast<uint64_t>(i))) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+            workers.emplace_back([&] {
+                while (consumed.load() < items) {
+                    if (counted.dequeue()) {
+                        consumed.fetch_add(1);
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        auto& tracer = counted.tracer();
+        std::cout << "Traced queue: " << tracer.enqueues << " enqueues, " << tracer.dequeues << " dequeues, "
+                  << tracer.retries << " CAS retries\n";
+        ok &= tracer.enqueues == items && tracer.dequeues == items;
+    }
+
+    // Crash dump: a child records an event and aborts, the handler leaves its rings in the file
+    {
+        const std::string crash_path = temp_path(fd);
+        const pid_t child = fork();
+        if (child == 0) {
+            FlightRecorder::install_crash_handler(fd);
+            FlightRecorder::record("about to crash", TracePhase::instant, 42);
+            std::abort();
+        }
+        int status = 0;
+        waitpid(child, &status, 0);
+        close(fd);
+        std::ifstream in(crash_path, std::ios::binary);
+        bool found = false;
+        for (const auto& event : FlightRecorder::read_binary(in)) {
+            found |= event.name == "about to crash" && event.arg == 42;
+        }
+        std::cout << "Crash dump: child " << (WIFSIGNALED(status) ? strsignal(WTERMSIG(status)) : "exited")
+                  << ", last event " << (found ? "recovered" : "MISSING") << "\n";
+        ok &= WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT && found;
+        std::remove(crash_path.c_str());
+    }
+
+    // Recording cost
+    {
+        constexpr int calls = 1000000;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < calls; ++i) {
+            FlightRecorder::record("cost", TracePhase::instant, static_cast<uint64_t>(i));
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+        std::cout << "Recording cost: ~" << static_cast<int>(elapsed.count() / calls) << " ns per event\n";
+    }
+
+    std::cout << "Flight recorder: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
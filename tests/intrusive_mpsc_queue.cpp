@@ -0,0 +1,72 @@
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "intrusive_mpsc_queue.hpp"
+
+namespace {
+
+struct Message : lockfreekit::IntrusiveMPSCNode {
+    int producer = 0;
+    int seq = 0;
+};
+
+}  // namespace
+
+int main() {
+    using namespace lockfreekit;
+
+    // Example: the first push into an empty mailbox reports the transition
+    IntrusiveMPSCQueue<Message> mailbox;
+    Message messages[3];
+    for (int i = 0; i < 3; ++i) {
+        messages[i].seq = i;
+        const bool became_non_empty = mailbox.push(&messages[i]);
+        std::cout << "Pushed " << i << (became_non_empty ? " (mailbox became non-empty)" : "") << "\n";
+    }
+    while (Message* m = mailbox.pop()) {
+        std::cout << "Popped " << m->seq << "\n";
+    }
+    std::cout << "Mailbox empty: " << std::boolalpha << mailbox.empty() << "\n\n";
+
+    // Stress: producers push pre-allocated messages, one consumer checks per-producer order
+    constexpr int producers = 4;
+    constexpr int per_producer = 100000;
+    std::vector<std::vector<Message>> storage(producers, std::vector<Message>(per_producer));
+    IntrusiveMPSCQueue<Message> queue;
+    std::atomic<int> wakeups{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < per_producer; ++i) {
+                storage[p][i].producer = p;
+                storage[p][i].seq = i;
+                if (queue.push(&storage[p][i])) {
+                    wakeups.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    bool ok = true;
+    std::vector<int> last(producers, -1);
+    for (int received = 0; received < producers * per_producer;) {
+        if (Message* m = queue.pop()) {
+            ok &= m->seq == last[m->producer] + 1;
+            last[m->producer] = m->seq;
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    ok &= queue.pop() == nullptr && queue.empty() && wakeups.load() >= 1;
+    std::cout << "Intrusive MPSC stress: " << (ok ? "passed" : "FAILED") << " (" << wakeups.load()
+              << " empty -> non-empty transitions)\n";
+    return ok ? 0 : 1;
+}
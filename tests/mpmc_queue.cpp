@@ -1,9 +1,53 @@
+#include <atomic>
+#include <cstdint>
 #include <iostream>
 #include <thread>
 #include <vector>
 
 #include "mpmc_queue.hpp"
 
+namespace {
+
+// Three producers and three consumers move 1..per_producer each; checks that every value arrives exactly once.
+template <typename Queue>
+bool stress(Queue& queue, uint32_t per_producer) {
+    constexpr int producers = 3;
+    constexpr int consumers = 3;
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint32_t> received{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            for (uint32_t i = 1; i <= per_producer; ++i) {
+                while (!queue.enqueue(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            while (received.load() < producers * per_producer) {
+                if (auto val = queue.dequeue()) {
+                    sum.fetch_add(*val);
+                    received.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    const uint64_t expected = uint64_t{producers} * per_producer * (per_producer + 1) / 2;
+    return sum.load() == expected && !queue.dequeue() && queue.approx_size() == 0;
+}
+
+}  // namespace
+
 int main() {
     using namespace lockfreekit;
 
@@ -53,6 +97,25 @@ int main() {
     producer.join();
     consumer.join();
 
-    std::cout << "Static queue approx size: " << static_queue.approx_size() << "\n";
-    return 0;
-}
\ No newline at end of file
+    std::cout << "Static queue approx size: " << static_queue.approx_size() << "\n\n";
+
+    // Example 3: 32-bit payloads use packed single-word slots. Capacity 1 and 2 make the sequence
+    // wrap around the ring on every operation, with several producers and consumers racing on it.
+    bool ok = true;
+    for (size_t capacity : {1, 2, 64}) {
+        MPMCQueue<uint32_t> packed_queue(capacity);
+        ok &= stress(packed_queue, 20000);
+    }
+    std::cout << "Packed queue stress: " << (ok ? "passed" : "FAILED") << "\n";
+
+    // Example 4: 16-bit indices wrap after 65536 operations, so these runs cross the wrap point several
+    // times, both with separate sequences and with packed slots.
+    MPMCQueue<uint64_t, 0, uint16_t> narrow_queue(4);
+    MPMCQueue<uint32_t, 8, uint16_t> narrow_packed_queue;
+    MPMCQueue<uint64_t, 0, uint32_t> compact_queue(1024);
+    ok &= stress(narrow_queue, 100000);
+    ok &= stress(narrow_packed_queue, 100000);
+    ok &= stress(compact_queue, 20000);
+    std::cout << "Narrow index stress: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
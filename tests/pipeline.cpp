@@ -0,0 +1,106 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "pipeline.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+
+struct Frame {
+    uint64_t id = 0;
+    uint64_t payload = 0;
+};
+
+void print(const std::vector<StageStats>& stats) {
+    for (const auto& s : stats) {
+        std::cout << "  " << s.name << " x" << s.parallelism << ": in " << s.items_in << ", out " << s.items_out
+                  << ", queue " << s.queue_kind << " " << s.queue_depth << "/" << s.queue_capacity << "\n";
+    }
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+
+    // decode -> enrich (2 parking threads) -> route (drops odd ids) -> encode
+    constexpr uint64_t frames = 200000;
+    uint64_t next_id = 0;
+    uint64_t checksum = 0;
+    uint64_t encoded = 0;
+    {
+        Pipeline pipeline;
+        auto& decode = pipeline.add_source<Frame>("decode", [&](Emitter<Frame>& emit) {
+            if (next_id == frames) {
+                return false;
+            }
+            emit(Frame{next_id, next_id});
+            ++next_id;
+            return true;
+        });
+        auto& enrich = pipeline.add_stage<Frame, Frame>(
+            "enrich", [](Frame frame, Emitter<Frame>& emit) { emit(Frame{frame.id, frame.payload * 3}); },
+            {.parallelism = 2, .wait = WaitMode::park});
+        auto& route = pipeline.add_stage<Frame, uint64_t>(
+            "route",
+            [](Frame frame, Emitter<uint64_t>& emit) {
+                if (frame.id % 2 == 0) {
+                    emit(frame.payload);
+                }
+            },
+            {.cpu = 0, .queue_capacity = 256});
+        auto& encode = pipeline.add_sink<uint64_t>("encode", [&](uint64_t value) {
+            checksum += value;
+            ++encoded;
+        });
+        pipeline.connect(decode, enrich);
+        pipeline.connect(enrich, route);
+        pipeline.connect(route, encode);
+        pipeline.start();
+        pipeline.wait();
+
+        const auto stats = pipeline.stats();
+        std::cout << "Pipeline finished: " << std::boolalpha << pipeline.finished() << "\n";
+        print(stats);
+        // Sum of 3 * id over even ids below `frames`
+        const uint64_t expected = 3 * (frames / 2) * (frames - 2) / 2;
+        ok &= pipeline.finished() && encoded == frames / 2 && checksum == expected;
+        ok &= std::string(stats[1].queue_kind) == "mpmc" && std::string(stats[2].queue_kind) == "mpmc" &&
+              std::string(stats[3].queue_kind) == "spsc";
+        ok &= stats[0].items_out == frames && stats[1].items_in == frames && stats[3].items_in == frames / 2;
+    }
+
+    // Fan-in from two endless sources, ended by stop()
+    {
+        std::atomic<uint64_t> received{0};
+        Pipeline pipeline;
+        auto counting_source = [](Emitter<int>& emit) {
+            emit(1);
+            return true;
+        };
+        auto& left = pipeline.add_source<int>("left", counting_source);
+        auto& right = pipeline.add_source<int>("right", counting_source);
+        auto& sink = pipeline.add_sink<int>(
+            "sink", [&](int value) { received.fetch_add(value, std::memory_order_relaxed); },
+            {.wait = WaitMode::park});
+        pipeline.connect(left, sink);
+        pipeline.connect(right, sink);
+        pipeline.start();
+        while (received.load() < 10000) {
+            std::this_thread::yield();
+        }
+        pipeline.stop();
+        pipeline.wait();
+
+        const auto stats = pipeline.stats();
+        std::cout << "Stopped fan-in pipeline:\n";
+        print(stats);
+        ok &= stats[0].items_out + stats[1].items_out == received.load() && stats[2].queue_depth == 0;
+    }
+
+    std::cout << "Pipeline: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "queue_locks.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+
+// Threads increment plain counters under the lock; a lost update or two holders at once shows up in the totals
+template <typename Lock>
+bool hammer(const char* name, int threads, int per_thread) {
+    Lock lock;
+    uint64_t counter = 0;
+    uint64_t shadow = 0;
+    std::atomic<int> inside{0};
+    std::atomic<bool> overlap{false};
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < per_thread; ++i) {
+                std::lock_guard guard(lock);
+                if (inside.fetch_add(1, std::memory_order_relaxed) != 0) {
+                    overlap = true;
+                }
+                ++counter;
+                shadow += 2;
+                inside.fetch_sub(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                      (static_cast<double>(threads) * per_thread);
+    const auto expected = static_cast<uint64_t>(threads) * per_thread;
+    const bool ok = !overlap && counter == expected && shadow == 2 * expected;
+    std::cout << name << ": " << threads << " threads, counter " << counter << " of " << expected << ", ~" << ns
+              << " ns per lock/unlock" << (ok ? "" : "  BROKEN") << "\n";
+    return ok;
+}
+
+// Waiters queued behind a holder get the lock in arrival order
+template <typename Lock>
+bool fifo(const char* name) {
+    constexpr int waiters = 4;
+    Lock lock;
+    std::vector<int> order;
+    std::vector<std::thread> threads;
+    lock.lock();
+    for (int w = 0; w < waiters; ++w) {
+        threads.emplace_back([&, w] {
+            std::lock_guard guard(lock);
+            order.push_back(w);
+        });
+        // Long enough for the waiter to enqueue (and, for HybridMutex, to park)
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    lock.unlock();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    bool ok = order.size() == waiters;
+    for (int w = 0; ok && w < waiters; ++w) {
+        ok = order[static_cast<size_t>(w)] == w;
+    }
+    std::cout << name << ": waiters served in arrival order: " << (ok ? "yes" : "NO") << "\n";
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+
+    // Example: std::lock_guard / try_lock, nested locks of different kinds
+    {
+        McsLock mcs;
+        ClhLock clh;
+        HybridMutex hybrid;
+        {
+            std::lock_guard a(mcs);
+            std::lock_guard b(clh);
+            std::lock_guard c(hybrid);
+            ok &= !mcs.try_lock() && !hybrid.try_lock();
+        }
+        ok &= mcs.try_lock() && hybrid.try_lock();
+        mcs.unlock();
+        hybrid.unlock();
+        std::cout << "Nested McsLock, ClhLock, HybridMutex: " << (ok ? "ok" : "BROKEN") << "\n";
+    }
+
+    ok &= fifo<McsLock>("McsLock");
+    ok &= fifo<ClhLock>("ClhLock");
+    ok &= fifo<HybridMutex>("HybridMutex");
+
+    constexpr int threads = 6;
+    constexpr int per_thread = 20000;
+    ok &= hammer<McsLock>("McsLock", threads, per_thread);
+    ok &= hammer<ClhLock>("ClhLock", threads, per_thread);
+    ok &= hammer<HybridMutex>("HybridMutex", threads, per_thread);
+
+    std::cout << "Queue locks: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
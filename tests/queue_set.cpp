@@ -0,0 +1,77 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "queue_set.hpp"
+
+int main() {
+    using namespace lockfreekit;
+
+    // Example: a router waiting on three queues
+    MPMCQueue<int> orders(8), quotes(8), admin(8);
+    QueueSet<int> set(3);
+    const size_t order_id = set.add(orders);
+    const size_t quote_id = set.add(quotes);
+    set.add(admin);
+    (void)set.enqueue(quote_id, 7);
+    (void)set.enqueue(order_id, 1);
+    while (auto selected = set.try_select()) {
+        std::cout << "Selected " << selected->value << " from queue " << selected->queue << "\n";
+    }
+    std::cout << "\n";
+
+    // Stress: 4 producers spread over 24 queues in bursts (so consumers park in between), 2 consumers select
+    constexpr size_t queue_count = 24;
+    constexpr int producers = 4;
+    constexpr uint64_t per_producer = 50000;
+    std::vector<std::unique_ptr<MPMCQueue<uint64_t>>> queues;
+    QueueSet<uint64_t> shared(queue_count);
+    for (size_t q = 0; q < queue_count; ++q) {
+        queues.push_back(std::make_unique<MPMCQueue<uint64_t>>(64));
+        shared.add(*queues.back());
+    }
+
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> sum{0};
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < 2; ++c) {
+        consumers.emplace_back([&] {
+            while (auto selected = shared.select()) {
+                sum.fetch_add(selected->value, std::memory_order_relaxed);
+                received.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (uint64_t i = 0; i < per_producer; ++i) {
+                const size_t q = (p * 7 + i) % queue_count;
+                while (!shared.enqueue(q, i)) {
+                    std::this_thread::yield();
+                }
+                if (i % 10000 == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    while (received.load() < producers * per_producer) {
+        std::this_thread::yield();
+    }
+    shared.close();
+    for (auto& t : consumers) {
+        t.join();
+    }
+
+    const uint64_t expected = producers * (per_producer * (per_producer - 1) / 2);
+    const bool ok = received.load() == producers * per_producer && sum.load() == expected && !shared.try_select();
+    std::cout << "Queue set stress: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,269 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rcu_cell.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+
+std::atomic<int64_t> live_tables{0};
+
+// A routing table whose entries all carry its generation; a reader seeing them disagree saw a freed copy
+struct RoutingTable {
+    explicit RoutingTable(uint64_t generation) : generation(generation) {
+        routes.assign(16, generation);
+        live_tables.fetch_add(1);
+    }
+    RoutingTable(const RoutingTable& other) : generation(other.generation), routes(other.routes) {
+        live_tables.fetch_add(1);
+    }
+    ~RoutingTable() {
+        generation = ~uint64_t{0};  // Likely to trip the check on a use after free
+        live_tables.fetch_sub(1);
+    }
+
+    bool consistent() const {
+        for (const uint64_t route : routes) {
+            if (route != generation) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint64_t generation;
+    std::vector<uint64_t> routes;
+};
+
+template <typename Read>
+double read_cost(int threads, int per_thread, Read&& read) {
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] { read(per_thread); });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+           (static_cast<double>(threads) * per_thread);
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+
+    // Example: epoch mode read, update, modify, publish and reclaim
+    {
+        RcuCell<std::map<std::string, int>> routes(std::make_unique<std::map<std::string, int>>(), 2);
+        auto& reader = routes.register_reader();
+        routes.modify([](auto& table) { table["orders"] = 3; });
+        {
+            auto table = routes.read(reader);
+            auto nested = routes.read(reader);
+            std::cout << "orders -> queue " << table->at("orders") << "\n";
+            ok &= table->at("orders") == 3 && nested.get() == table.get();
+        }
+        routes.update(std::make_unique<std::map<std::string, int>>(std::map<std::string, int>{{"fills", 5}}));
+        ok &= routes.read(reader)->count("fills") == 1;
+
+        {
+            auto held = routes.read(reader);  // Keeps the copy about to be replaced alive
+            routes.publish(std::make_unique<std::map<std::string, int>>());
+            ok &= routes.reclaim() == 0 && held->count("fills") == 1;
+        }
+        ok &= routes.reclaim() == 1;
+    }
+
+    // Example: qsbr mode
+    {
+        RcuCell<RoutingTable, RcuMode::qsbr> table(std::make_unique<RoutingTable>(1), 2);
+        auto& worker = table.register_reader();
+        ok &= table.get()->generation == 1;
+        table.quiescent(worker);
+        table.publish(std::make_unique<RoutingTable>(2));
+        ok &= table.reclaim() == 0;  // The worker has not passed a quiescent state since
+        table.quiescent(worker);
+        ok &= table.reclaim() == 1 && table.get()->generation == 2;
+        table.offline(worker);
+        table.update(std::make_unique<RoutingTable>(3));  // Does not wait for an offline reader
+        table.online(worker);
+        ok &= table.get()->generation == 3;
+    }
+    ok &= live_tables == 0;
+
+    // Stress, both modes: readers check every copy they see while a writer replaces it through update() and
+    // publish()/reclaim(); no copy may be freed under a reader, and every copy must be freed once
+    constexpr int readers = 4;
+    constexpr uint64_t updates = 500;
+    {
+        RcuCell<RoutingTable> table(std::make_unique<RoutingTable>(0), readers);
+        std::atomic<bool> writing{true};
+        std::atomic<bool> broken{false};
+        std::atomic<uint64_t> reads{0};
+        std::atomic<int> started{0};
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&] {
+                auto& reader = table.register_reader();
+                started.fetch_add(1);
+                uint64_t local = 0;
+                uint64_t last = 0;
+                while (writing.load(std::memory_order_relaxed)) {
+                    auto current = table.read(reader);
+                    if (!current->consistent() || current->generation < last) {
+                        broken = true;
+                    }
+                    last = current->generation;
+                    ++local;
+                }
+                reads.fetch_add(local);
+            });
+        }
+        while (started.load() < readers) {
+            std::this_thread::yield();
+        }
+        for (uint64_t i = 1; i <= updates; ++i) {
+            if (i % 2 == 0) {
+                table.update(std::make_unique<RoutingTable>(i));
+            } else {
+                table.publish(std::make_unique<RoutingTable>(i));
+                (void)table.reclaim();
+            }
+        }
+        writing = false;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        (void)table.reclaim();
+        std::cout << "Epoch mode: " << reads << " reads during " << updates
+                  << " updates: " << (broken ? "BROKEN copy seen" : "every copy intact") << ", live copies "
+                  << live_tables << "\n";
+        ok &= !broken && live_tables == 1;
+    }
+    ok &= live_tables == 0;
+    {
+        RcuCell<RoutingTable, RcuMode::qsbr> table(std::make_unique<RoutingTable>(0), readers);
+        std::atomic<bool> writing{true};
+        std::atomic<bool> broken{false};
+        std::atomic<uint64_t> reads{0};
+        std::atomic<int> started{0};
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r] {
+                auto& worker = table.register_reader();
+                started.fetch_add(1);
+                uint64_t local = 0;
+                while (writing.load(std::memory_order_relaxed)) {
+                    // One "message": several lookups, then a quiescent state between messages
+                    for (int lookup = 0; lookup < 8; ++lookup) {
+                        if (!table.get()->consistent()) {
+                            broken = true;
+                        }
+                        ++local;
+                    }
+                    table.quiescent(worker);
+                    if (r == 0 && local % 1024 == 0) {
+                        table.offline(worker);  // As if blocking on an empty queue
+                        std::this_thread::yield();
+                        table.online(worker);
+                    }
+                }
+                table.offline(worker);
+                reads.fetch_add(local);
+            });
+        }
+        while (started.load() < readers) {
+            std::this_thread::yield();
+        }
+        for (uint64_t i = 1; i <= updates; ++i) {
+            if (i % 2 == 0) {
+                table.update(std::make_unique<RoutingTable>(i));
+            } else {
+                table.publish(std::make_unique<RoutingTable>(i));
+                (void)table.reclaim();
+            }
+        }
+        writing = false;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        (void)table.reclaim();
+        std::cout << "QSBR mode: " << reads << " reads during " << updates
+                  << " updates: " << (broken ? "BROKEN copy seen" : "every copy intact") << ", live copies "
+                  << live_tables << "\n";
+        ok &= !broken && live_tables == 1;
+    }
+    ok &= live_tables == 0;
+
+    // Concurrent modify(): two writers bump the generation of the same cell; an increment made on a copy that
+    // another writer already replaced would be lost
+    {
+        constexpr uint64_t per_writer = 2000;
+        RcuCell<RoutingTable> table(std::make_unique<RoutingTable>(0), 1);
+        std::vector<std::thread> writers;
+        for (int w = 0; w < 2; ++w) {
+            writers.emplace_back([&] {
+                for (uint64_t i = 0; i < per_writer; ++i) {
+                    table.modify([](RoutingTable& copy) {
+                        std::this_thread::yield();  // Widens the window between the copy and its publication
+                        copy.routes.assign(copy.routes.size(), ++copy.generation);
+                    });
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        auto& reader = table.register_reader();
+        const uint64_t generation = table.read(reader)->generation;
+        std::cout << "Concurrent modify: generation " << generation << " of " << 2 * per_writer << "\n";
+        ok &= generation == 2 * per_writer && table.read(reader)->consistent();
+    }
+    ok &= live_tables == 0;
+
+    // Read cost without writers: an epoch mode critical section and a qsbr lookup with a quiescent state every
+    // 16 lookups
+    {
+        const int threads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+        constexpr int per_thread = 2000000;
+        RcuCell<RoutingTable> epoch(std::make_unique<RoutingTable>(1), threads);
+        RcuCell<RoutingTable, RcuMode::qsbr> qsbr(std::make_unique<RoutingTable>(1), threads);
+        std::atomic<uint64_t> sink{0};
+        const double epoch_ns = read_cost(threads, per_thread, [&](int count) {
+            auto& reader = epoch.register_reader();
+            uint64_t sum = 0;
+            for (int i = 0; i < count; ++i) {
+                sum += epoch.read(reader)->generation;
+            }
+            sink.fetch_add(sum);
+        });
+        const double qsbr_ns = read_cost(threads, per_thread, [&](int count) {
+            auto& worker = qsbr.register_reader();
+            uint64_t sum = 0;
+            for (int i = 0; i < count; ++i) {
+                sum += qsbr.get()->generation;
+                if (i % 16 == 15) {
+                    qsbr.quiescent(worker);
+                }
+            }
+            qsbr.offline(worker);
+            sink.fetch_add(sum);
+        });
+        std::cout << threads << " readers: epoch mode ~" << epoch_ns << " ns, qsbr ~" << qsbr_ns
+                  << " ns per read\n";
+        ok &= sink == 2ull * threads * per_thread;
+    }
+
+    std::cout << "RCU cell: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
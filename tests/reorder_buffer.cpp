@@ -0,0 +1,76 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "mpmc_queue.hpp"
+#include "reorder_buffer.hpp"
+
+namespace {
+
+struct Job {
+    uint64_t seq = 0;
+    uint64_t input = 0;
+};
+
+}  // namespace
+
+int main() {
+    using namespace lockfreekit;
+
+    // Example: items finish out of order and come out in order
+    ReorderBuffer<int> buffer(4, 10);
+    (void)buffer.try_insert(12, 120);
+    (void)buffer.try_insert(11, 110);
+    auto print = [](int v) { std::cout << "Released " << v << "\n"; };
+    std::cout << "Released before 10 arrived: " << buffer.release(print) << "\n";
+    std::cout << "Insert 14 (window full): " << std::boolalpha << buffer.try_insert(14, 140) << "\n";
+    (void)buffer.try_insert(10, 100);
+    const size_t released = buffer.release(print);
+    std::cout << "Released after 10 arrived: " << released << "\n";
+    std::cout << "Next sequence: " << buffer.next_sequence() << "\n\n";
+
+    // Stress: workers pull jobs from one MPMCQueue, the consumer must see results in submission order
+    constexpr uint64_t jobs = 200000;
+    constexpr int workers = 4;
+    MPMCQueue<Job> input(256);
+    ReorderBuffer<uint64_t> output(64);
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> threads;
+    threads.emplace_back([&] {
+        for (uint64_t i = 0; i < jobs; ++i) {
+            while (!input.enqueue(Job{i, i})) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (int w = 0; w < workers; ++w) {
+        threads.emplace_back([&] {
+            while (!done.load()) {
+                if (auto job = input.dequeue()) {
+                    output.insert(job->seq, job->input * job->input);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    bool ok = true;
+    uint64_t expected = 0;
+    while (expected < jobs) {
+        if (output.release([&](uint64_t v) { ok &= v == expected * expected, ++expected; }) == 0) {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    ok &= output.next_sequence() == jobs && !output.try_pop();
+    std::cout << "Reorder buffer stress: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
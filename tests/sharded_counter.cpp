@@ -0,0 +1,108 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "sharded_counter.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+
+// Nanoseconds per add() with `threads` threads hammering one counter
+template <typename Add>
+double cost(int threads, int per_thread, Add&& add) {
+    std::vector<std::thread> workers;
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < per_thread; ++i) {
+                add();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() / (static_cast<double>(threads) * per_thread);
+}
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+
+    // Example: the approximate read lags until a cell reaches the batch, the exact read does not
+    {
+        ShardedCounter counter(4, 10);
+        for (int i = 0; i < 25; ++i) {
+            counter.increment();
+        }
+        std::cout << "After 25 increments: approx " << counter.approx() << ", sum " << counter.sum() << "\n";
+        ok &= counter.sum() == 25 && counter.approx() == 20;
+        counter.add(-25);
+        ok &= counter.sum() == 0;
+    }
+
+    // Stress: 8 threads add and subtract concurrently; the exact read must be exact once they are done, and
+    // the approximate read within cells * batch all along
+    {
+        constexpr int threads = 8;
+        constexpr int per_thread = 200000;
+        ShardedCounter counter(0, 32);
+        std::atomic<bool> running{true};
+        std::atomic<int64_t> expected{0};
+        std::atomic<bool> bound_ok{true};
+        std::thread reader([&] {
+            // Each thread's net total only grows, so the true value is always in [0, threads * per_thread]
+            const int64_t slack = static_cast<int64_t>(counter.cells()) * 32 * 2;
+            while (running.load()) {
+                const int64_t approx = counter.approx();
+                if (approx < -slack || approx > int64_t{threads} * per_thread + slack) {
+                    bound_ok = false;
+                }
+            }
+        });
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                int64_t net = 0;
+                for (int i = 0; i < per_thread; ++i) {
+                    const int64_t delta = (i + t) % 3 == 0 ? -1 : 2;
+                    counter.add(delta);
+                    net += delta;
+                }
+                expected.fetch_add(net);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        running = false;
+        reader.join();
+        const int64_t slack = static_cast<int64_t>(counter.cells()) * 32;
+        std::cout << "Sum " << counter.sum() << " (expected " << expected << "), approx " << counter.approx()
+                  << ", " << counter.cells() << " cells\n";
+        ok &= counter.sum() == expected && counter.approx() >= expected - slack &&
+              counter.approx() <= expected + slack && bound_ok;
+    }
+
+    // Cost against a single shared atomic
+    {
+        const int threads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+        constexpr int per_thread = 1000000;
+        std::atomic<int64_t> shared{0};
+        ShardedCounter counter;
+        const double atomic_ns = cost(threads, per_thread, [&] { shared.fetch_add(1, std::memory_order_relaxed); });
+        const double sharded_ns = cost(threads, per_thread, [&] { counter.increment(); });
+        std::cout << threads << " threads: shared atomic ~" << atomic_ns << " ns, sharded ~" << sharded_ns
+                  << " ns per add\n";
+        ok &= counter.sum() == int64_t{threads} * per_thread;
+    }
+
+    std::cout << "Sharded counter: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
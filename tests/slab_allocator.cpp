@@ -0,0 +1,115 @@
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mpmc_queue.hpp"
+#include "slab_allocator.hpp"
+
+namespace {
+
+using namespace lockfreekit;
+
+struct Message {
+    uint8_t* payload = nullptr;
+    uint32_t length = 0;
+    uint8_t fill = 0;
+};
+
+}  // namespace
+
+int main() {
+    bool ok = true;
+
+    // Example: size classes, reuse of a freed block, a large allocation, objects
+    {
+        SlabAllocator slab;
+        std::cout << "Block sizes for 1, 17, 129, 1000, 4096 bytes: " << SlabAllocator::block_size(1) << " "
+                  << SlabAllocator::block_size(17) << " " << SlabAllocator::block_size(129) << " "
+                  << SlabAllocator::block_size(1000) << " " << SlabAllocator::block_size(4096) << "\n";
+        ok &= SlabAllocator::block_size(1) == 16 && SlabAllocator::block_size(129) == 160 &&
+              SlabAllocator::block_size(1000) == 1024 && SlabAllocator::block_size(4096) == 4096;
+        for (size_t bytes = 1; bytes <= SlabAllocator::MAX_SMALL; ++bytes) {
+            const size_t block = SlabAllocator::block_size(bytes);
+            ok &= block >= bytes && block % 16 == 0 && (bytes == 1 || SlabAllocator::block_size(bytes - 1) <= block);
+        }
+
+        void* first = slab.allocate(40);
+        slab.deallocate(first);
+        ok &= slab.allocate(48) == first;  // Same class, the freed block comes back
+        void* large = slab.allocate(100000);
+        std::memset(large, 0xab, 100000);
+        slab.deallocate(large);
+        auto* text = slab.create<std::string>("pooled string that does not fit the small buffer");
+        ok &= *text == "pooled string that does not fit the small buffer";
+        slab.destroy(text);
+        slab.deallocate(first);
+    }
+
+    // Stress: 2 producers allocate and fill payloads, 2 consumers check and free them. Every free is a remote
+    // free; a block handed out twice would show up as a payload that changed under its consumer.
+    {
+        constexpr int producers = 2;
+        constexpr int consumers = 2;
+        constexpr int per_producer = 200000;
+        SlabAllocator slab;
+        MPMCQueue<Message> queue(512);
+        std::atomic<int> consumed{0};
+        std::atomic<bool> corrupted{false};
+        std::vector<std::thread> workers;
+        for (int p = 0; p < producers; ++p) {
+            workers.emplace_back([&, p] {
+                for (int i = 0; i < per_producer; ++i) {
+                    const auto length = static_cast<uint32_t>(1 + (i * 131 + p) % 6000);  // Some are large
+                    auto* payload = static_cast<uint8_t*>(slab.allocate(length));
+                    const auto fill = static_cast<uint8_t>(i + p);
+                    std::memset(payload, fill, length);
+                    while (!queue.enqueue(Message{payload, length, fill})) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (int c = 0; c < consumers; ++c) {
+            workers.emplace_back([&] {
+                while (consumed.load() < producers * per_producer) {
+                    const auto message = queue.dequeue();
+                    if (!message) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    for (uint32_t i = 0; i < message->length; ++i) {
+                        if (message->payload[i] != message->fill) {
+                            corrupted = true;
+                        }
+                    }
+                    slab.deallocate(message->payload);
+                    consumed.fetch_add(1);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        std::cout << "Cross-thread frees: " << consumed << ", corrupted payloads: " << (corrupted ? "yes" : "none")
+                  << "\n";
+        ok &= !corrupted;
+
+        // Short-lived threads adopt the heaps of exited ones instead of adding new heaps
+        const size_t heaps = slab.heap_count();
+        for (int round = 0; round < 20; ++round) {
+            std::thread([&] {
+                void* block = slab.allocate(64);
+                slab.deallocate(block);
+            }).join();
+        }
+        std::cout << "Heaps after 20 short-lived threads: " << slab.heap_count() << " (was " << heaps << ")\n";
+        ok &= slab.heap_count() == heaps;
+    }
+
+    std::cout << "Slab allocator: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "snzi.hpp"
+
+using namespace lockfreekit;
+
+int main() {
+    bool ok = true;
+
+    // Example: the indicator follows arrivals and departures at different leaves
+    {
+        Snzi snzi(4);
+        ok &= !snzi.query();
+        const Snzi::Ticket first = snzi.arrive();
+        Snzi::Ticket second = 0;
+        std::thread([&] { second = snzi.arrive(); }).join();
+        std::cout << "Two arrivals at leaves " << first << " and " << second << ": " << snzi.query() << "\n";
+        ok &= snzi.query();
+        snzi.depart(first);
+        ok &= snzi.query();
+        snzi.depart(second);
+        std::cout << "After both departed: " << snzi.query() << "\n";
+        ok &= !snzi.query();
+    }
+
+    // Stress: threads arrive and depart in a loop. A thread that has arrived must see the indicator set until it
+    // departs, and the indicator must be clear once everybody left.
+    {
+        constexpr int threads = 8;
+        constexpr int rounds = 100000;
+        for (const size_t leaves : {size_t{1}, size_t{2}, size_t{8}}) {
+            Snzi snzi(leaves);
+            std::atomic<bool> missed{false};
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; ++t) {
+                workers.emplace_back([&] {
+                    for (int i = 0; i < rounds; ++i) {
+                        const Snzi::Ticket ticket = snzi.arrive();
+                        if (!snzi.query()) {
+                            missed = true;
+                        }
+                        snzi.depart(ticket);
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            std::cout << leaves << " leaves: " << (missed ? "MISSED an arrival" : "no missed arrival")
+                      << ", final indicator " << snzi.query() << "\n";
+            ok &= !missed && !snzi.query();
+        }
+    }
+
+    // A long-lived arrival keeps the indicator set while other threads come and go
+    {
+        Snzi snzi(4);
+        const Snzi::Ticket held = snzi.arrive();
+        std::atomic<bool> cleared{false};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([&] {
+                for (int i = 0; i < 50000; ++i) {
+                    snzi.depart(snzi.arrive());
+                    if (!snzi.query()) {
+                        cleared = true;
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        ok &= !cleared && snzi.query();
+        snzi.depart(held);
+        ok &= !snzi.query();
+    }
+
+    std::cout << "SNZI: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
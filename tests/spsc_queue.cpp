@@ -0,0 +1,45 @@
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+#include "spsc_queue.hpp"
+
+int main() {
+    using namespace lockfreekit;
+
+    // Example: fill to capacity, then drain in order
+    SPSCQueue<int> queue(3);
+    for (int i = 0; i < 4; ++i) {
+        std::cout << "Enqueue " << i << ": " << (queue.enqueue(i) ? "ok" : "full") << "\n";
+    }
+    std::cout << "Queue approx size: " << queue.approx_size() << "\n";
+    while (auto v = queue.dequeue()) {
+        std::cout << "Dequeued " << *v << "\n";
+    }
+    std::cout << "Queue empty: " << std::boolalpha << queue.empty() << "\n\n";
+
+    // Stress: one producer, one consumer, values must arrive in order and wrap around the ring many times
+    constexpr uint64_t items = 1000000;
+    SPSCQueue<uint64_t> shared(100);
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < items; ++i) {
+            while (!shared.enqueue(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    bool ok = true;
+    for (uint64_t expected = 0; expected < items;) {
+        if (auto v = shared.dequeue()) {
+            ok &= *v == expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    ok &= shared.empty() && shared.approx_size() == 0;
+    std::cout << "SPSC stress: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
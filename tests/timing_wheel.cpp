@@ -0,0 +1,95 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "timing_wheel.hpp"
+
+namespace {
+
+struct Timeout {
+    uint32_t id = 0;
+    uint64_t deadline = 0;
+};
+
+}  // namespace
+
+int main() {
+    using namespace lockfreekit;
+
+    // Example: two connection timeouts, one cancelled when the connection answers
+    TimingWheel<int> wheel(8);
+    auto slow = wheel.schedule_in(5, 1);
+    auto fast = wheel.schedule_in(3, 2);
+    std::cout << "Cancelled connection 2: " << std::boolalpha << wheel.cancel(*fast) << "\n";
+    std::cout << "Cancel it again: " << wheel.cancel(*fast) << "\n";
+    for (uint64_t tick = 1; tick <= 6; ++tick) {
+        wheel.advance(tick, [&](int connection) { std::cout << "Tick " << tick << ": connection " << connection
+                                                            << " timed out\n"; });
+    }
+    std::cout << "Cancel after firing: " << wheel.cancel(*slow) << "\n\n";
+
+    // Stress: schedulers create timeouts (spanning every wheel level and the overflow list) and cancel most of
+    // them, while the owner advances time. Every timer must fire exactly once, never early, unless cancelled.
+    constexpr int schedulers = 3;
+    constexpr uint32_t per_scheduler = 100000;
+    constexpr uint32_t total = schedulers * per_scheduler;
+    TimingWheel<Timeout> timers(1 << 16);
+    std::vector<std::atomic<uint8_t>> fired(total);
+    std::vector<uint8_t> cancelled(total);
+    std::atomic<uint32_t> early{0};
+    std::atomic<int> running{schedulers};
+
+    std::vector<std::thread> threads;
+    for (int s = 0; s < schedulers; ++s) {
+        threads.emplace_back([&, s] {
+            uint64_t rng = s + 1;
+            for (uint32_t i = 0; i < per_scheduler; ++i) {
+                rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+                const uint32_t id = s * per_scheduler + i;
+                // Mostly short timeouts, some beyond 64^4 ticks
+                const uint64_t delay = (rng >> 60) == 0 ? (rng >> 20) % (uint64_t{1} << 26) : (rng >> 33) % 5000;
+                const uint64_t deadline = timers.current_tick() + delay;
+                std::optional<TimingWheel<Timeout>::Handle> handle;
+                while (!(handle = timers.schedule_at(deadline, Timeout{id, deadline}))) {
+                    std::this_thread::yield();  // Pool exhausted, wait for the owner to reclaim nodes
+                }
+                if ((rng >> 40) % 10 != 0) {
+                    cancelled[id] = timers.cancel(*handle);
+                }
+            }
+            running.fetch_sub(1);
+        });
+    }
+
+    // The owner advances in uneven batches and fast-forwards over the long timeouts once scheduling is done
+    uint64_t now = 0;
+    auto on_expire = [&](const Timeout& timeout) {
+        if (timeout.deadline > now) {
+            early.fetch_add(1);
+        }
+        fired[timeout.id].fetch_add(1);
+    };
+    while (running.load() > 0) {
+        now += 1 + now % 7;
+        timers.advance(now, on_expire);
+        std::this_thread::yield();
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    while (timers.advance(now, on_expire), timers.next_event_tick() != HierarchicalWheel::NEVER) {
+        now = timers.next_event_tick();
+    }
+
+    bool ok = early.load() == 0;
+    uint32_t fired_count = 0;
+    for (uint32_t id = 0; id < total; ++id) {
+        ok &= fired[id].load() == (cancelled[id] ? 0 : 1);
+        fired_count += fired[id].load();
+    }
+    std::cout << "Timing wheel stress: " << (ok ? "passed" : "FAILED") << " (" << fired_count << " of " << total
+              << " fired)\n";
+    return ok ? 0 : 1;
+}
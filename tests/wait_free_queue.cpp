@@ -0,0 +1,90 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "wait_free_queue.hpp"
+
+namespace {
+
+struct Item {
+    int producer;
+    int seq;
+};
+
+// Several producers and consumers on a queue with tiny segments, so segment allocation and reclamation
+// run constantly. Every item must arrive exactly once and in per-producer FIFO order.
+template <size_t segment_size>
+bool stress(int producers, int consumers, int per_producer) {
+    using namespace lockfreekit;
+
+    WaitFreeQueue<Item, segment_size> queue(producers + consumers);
+    std::vector<std::vector<Item>> items(producers, std::vector<Item>(per_producer));
+    std::vector<std::vector<int>> last_seen(consumers, std::vector<int>(producers, -1));
+    std::vector<int> received(consumers, 0);
+    std::atomic<int> remaining{producers * per_producer};
+    std::atomic<bool> ok{true};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            auto& handle = queue.register_thread();
+            for (int i = 0; i < per_producer; ++i) {
+                items[p][i] = Item{p, i};
+                queue.enqueue(handle, &items[p][i]);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            auto& handle = queue.register_thread();
+            while (remaining.load(std::memory_order_relaxed) > 0) {
+                Item* item = queue.dequeue(handle);
+                if (item == nullptr) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (item->seq <= last_seen[c][item->producer]) {
+                    ok = false;
+                }
+                last_seen[c][item->producer] = item->seq;
+                ++received[c];
+                remaining.fetch_sub(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    int total = 0;
+    for (int r : received) {
+        total += r;
+    }
+    return ok && total == producers * per_producer;
+}
+
+}  // namespace
+
+int main() {
+    using namespace lockfreekit;
+
+    // Example: single thread, one handle
+    WaitFreeQueue<int> queue(1);
+    auto& handle = queue.register_thread();
+    int values[5] = {0, 1, 2, 3, 4};
+    for (int& v : values) {
+        queue.enqueue(handle, &v);
+        std::cout << "Enqueued " << v << " (wait-free)\n";
+    }
+    while (int* v = queue.dequeue(handle)) {
+        std::cout << "Dequeued " << *v << " (wait-free)\n";
+    }
+    std::cout << "Wait-free queue approx size: " << queue.approx_size() << "\n\n";
+
+    bool ok = true;
+    ok &= stress<4>(4, 4, 20000);
+    ok &= stress<1022>(2, 6, 50000);
+    ok &= stress<2>(1, 1, 10000);
+    std::cout << "Wait-free queue stress: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "work_stealing_deque.hpp"
+
+int main() {
+    using namespace lockfreekit;
+
+    // Example: the owner pops LIFO, a thief steals FIFO
+    WorkStealingDeque<int> deque(8);
+    for (int i = 0; i < 4; ++i) {
+        (void)deque.push(i);
+    }
+    std::cout << "Stolen " << *deque.steal() << ", popped " << *deque.pop() << "\n";
+    std::cout << "Deque approx size: " << deque.approx_size() << "\n\n";
+
+    // Stress: the owner pushes and pops while thieves steal; every item must be taken exactly once
+    constexpr uint32_t items = 200000;
+    constexpr int thieves = 3;
+    WorkStealingDeque<uint32_t> shared(64);
+    std::vector<std::atomic<uint8_t>> taken(items);
+    std::atomic<uint32_t> count{0};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thieves; ++t) {
+        threads.emplace_back([&] {
+            while (count.load() < items) {
+                if (auto v = shared.steal()) {
+                    taken[*v].fetch_add(1);
+                    count.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (uint32_t i = 0; i < items; ++i) {
+        while (!shared.push(i)) {
+            if (auto v = shared.pop()) {
+                taken[*v].fetch_add(1);
+                count.fetch_add(1);
+            }
+        }
+        if (i % 3 == 0) {
+            if (auto v = shared.pop()) {
+                taken[*v].fetch_add(1);
+                count.fetch_add(1);
+            }
+        }
+    }
+    while (auto v = shared.pop()) {
+        taken[*v].fetch_add(1);
+        count.fetch_add(1);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    bool ok = count.load() == items;
+    for (auto& t : taken) {
+        ok &= t.load() == 1;
+    }
+    std::cout << "Work-stealing deque stress: " << (ok ? "passed" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}